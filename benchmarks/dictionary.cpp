@@ -0,0 +1,373 @@
+/*
+ * SPDX-FileCopyrightText: 2026~2026 CSSlayer <wengxt@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "jyutpingdata.h"
+#include "jyutpingdictionary_p.h"
+#include "jyutpingmatchstate_p.h"
+#include "libime/core/segmentgraph.h"
+#include "libime/jyutping/jyutpingdictionary.h"
+#include "libime/jyutping/jyutpingencoder.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace libime;
+using namespace libime::jyutping;
+
+namespace {
+
+// A common sentence used as user input, the first n syllables are used for
+// the input of length n.
+constexpr std::array<std::string_view, 40> inputSyllables = {
+    "ngo", "dei", "heoi", "sik", "faan", "nei", "hou", "maa", "hoeng", "gong",
+    "daai", "hok", "gam", "jat", "tin", "hei", "hou", "hou", "ngo", "soeng",
+    "heoi", "maai", "je", "zung", "jau", "hou", "do", "si", "gaan", "gin",
+    "pang", "jau", "jat", "cai", "king", "gai", "zau", "faan", "uk", "kei"};
+
+constexpr std::array<size_t, 8> inputLengths = {1, 2, 4, 8, 16, 24, 32, 40};
+
+double minTime = 0.5;
+volatile size_t sink;
+
+// Run func until it takes at least minTime seconds, and print the average
+// time of a single run. func returns a number that is kept alive so the
+// work is not optimized out.
+template <typename T>
+void run(std::string_view name, const T &func) {
+    using clock = std::chrono::steady_clock;
+    size_t iterations = 0;
+    size_t result = 0;
+    const auto start = clock::now();
+    std::chrono::duration<double> elapsed{0};
+    do {
+        result += func();
+        iterations++;
+        elapsed = clock::now() - start;
+    } while (elapsed.count() < minTime);
+    sink = result;
+    std::printf("%-48.*s %14.0f ns %10zu\n", static_cast<int>(name.size()),
+                name.data(), elapsed.count() * 1e9 / iterations, iterations);
+}
+
+// Run func once, and print the throughput of the items it processed. func
+// returns the number of bytes it processed.
+template <typename T>
+void runOnce(std::string_view name, size_t items, const T &func) {
+    const auto start = std::chrono::steady_clock::now();
+    const size_t bytes = func();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::printf("%-48.*s %14.0f ns %10.1f MB/s %12.0f items/s\n",
+                static_cast<int>(name.size()), name.data(),
+                elapsed.count() * 1e9, bytes / elapsed.count() / 1e6,
+                items / elapsed.count());
+}
+
+void usage(const char *argv0) {
+    std::cout << "Usage: " << argv0 << " [-d <dict>] [-n <entries>] [-t <time>]"
+              << std::endl
+              << "-d: Jyutping dictionary, default is the one in build tree"
+              << std::endl
+              << "-n: Number of entries of the synthetic dictionary, default "
+                 "is 5000000, 0 to skip"
+              << std::endl
+              << "-t: Minimum time in seconds of each benchmark, default is "
+                 "0.5"
+              << std::endl
+              << "-h: Show this help" << std::endl;
+}
+
+// Write a random text dictionary with valid syllables, and returns the
+// number of bytes written.
+size_t writeSyntheticDictionary(const std::filesystem::path &path,
+                                size_t entries) {
+    std::vector<std::string_view> syllables;
+    for (const auto &entry : getJyutpingMap()) {
+        if (!entry.fuzzy()) {
+            syllables.push_back(entry.jyutpingView());
+        }
+    }
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> syllable(0, syllables.size() - 1);
+    std::uniform_int_distribution<uint32_t> hanzi(0x4E00, 0x9FA5);
+    std::discrete_distribution<size_t> length({0, 10, 50, 25, 15});
+    std::uniform_real_distribution<float> cost(-8.0f, -3.0f);
+
+    std::ofstream out(path);
+    std::string line;
+    for (size_t i = 0; i < entries; i++) {
+        auto n = length(gen);
+        line.clear();
+        for (size_t j = 0; j < n; j++) {
+            auto c = hanzi(gen);
+            line.push_back(static_cast<char>(0xE0 | (c >> 12)));
+            line.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            line.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+        line.push_back(' ');
+        for (size_t j = 0; j < n; j++) {
+            if (j) {
+                line.push_back('\'');
+            }
+            line.append(syllables[syllable(gen)]);
+        }
+        out << line << ' ' << cost(gen) << '\n';
+    }
+    return out.tellp();
+}
+
+void benchmarkLoadSave(std::string_view name, JyutpingDictionary &dict) {
+    const auto entries = dict.trie(JyutpingDictionary::SystemDict)->size();
+    std::stringstream buffer;
+    runOnce(std::string(name) + "/save", entries, [&dict, &buffer]() {
+        dict.save(JyutpingDictionary::SystemDict, buffer,
+                  JyutpingDictFormat::Binary);
+        return static_cast<size_t>(buffer.tellp());
+    });
+    const auto bytes = static_cast<size_t>(buffer.tellp());
+    JyutpingDictionary loaded;
+    runOnce(std::string(name) + "/load", entries, [&loaded, &buffer, bytes]() {
+        loaded.load(JyutpingDictionary::SystemDict, buffer,
+                    JyutpingDictFormat::Binary);
+        return bytes;
+    });
+}
+
+// Build the path of graph nodes at the syllable boundaries of the first n
+// input syllables.
+SegmentGraphPath syllablePath(const SegmentGraph &graph, size_t n) {
+    SegmentGraphPath path;
+    size_t offset = 0;
+    path.push_back(&graph.node(offset));
+    for (size_t i = 0; i < n; i++) {
+        offset += inputSyllables[i].size();
+        path.push_back(&graph.node(offset));
+    }
+    return path;
+}
+
+// Traverse the trie along the syllables, returns the paths after every
+// syllable until there is no match.
+MatchedJyutpingPaths
+traverseSyllables(JyutpingTrieRef trie,
+                  std::span<const std::span<const JyutpingSyllableExpansion>>
+                      expansions) {
+    MatchedJyutpingPaths paths;
+    MatchedJyutpingPath path(trie, 0, {});
+    path.triePositions().emplace_back(0, 0);
+    JyutpingTriePositions positions;
+    for (size_t i = 0; i < expansions.size(); i++) {
+        traverseAlongPathOneStepBySyllables(path, expansions[i], positions);
+        if (positions.empty()) {
+            break;
+        }
+        path = MatchedJyutpingPath(trie, i + 1, {});
+        path.triePositions() = positions;
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+void benchmarkLookup(std::string_view name, const JyutpingDictionary &dict) {
+    const JyutpingTrieRef trie(dict.trie(JyutpingDictionary::SystemDict));
+    for (auto n : inputLengths) {
+        std::string input;
+        std::string fullJyutping;
+        std::string initials;
+        std::vector<std::span<const JyutpingSyllableExpansion>> expansions;
+        for (size_t i = 0; i < n; i++) {
+            input.append(inputSyllables[i]);
+            if (i) {
+                fullJyutping.push_back('\'');
+            }
+            fullJyutping.append(inputSyllables[i]);
+            expansions.push_back(getSyllableExpansion(inputSyllables[i]));
+        }
+        const auto encoded = JyutpingEncoder::encodeFullJyutping(fullJyutping);
+        for (size_t i = 0; i < encoded.size(); i += 2) {
+            initials.push_back(encoded[i]);
+            initials.push_back(0);
+        }
+        const auto graph = JyutpingEncoder::parseUserJyutping(input);
+        const auto suffix = "/" + std::to_string(n);
+        const std::string prefix(name);
+
+        run(prefix + "/matchPrefix" + suffix, [&dict, &graph]() {
+            size_t words = 0;
+            dict.matchPrefix(graph, [&words](const SegmentGraphPath &,
+                                             WordNode &, float,
+                                             std::unique_ptr<LatticeNodeData>) {
+                words++;
+                return true;
+            });
+            return words;
+        });
+
+        run(prefix + "/traverseAlongPathOneStepBySyllables" + suffix,
+            [&trie, &expansions]() {
+                return traverseSyllables(trie, expansions).size();
+            });
+
+        const auto paths = traverseSyllables(trie, expansions);
+        run(prefix + "/matchWordsOnTrie" + suffix, [&paths]() {
+            size_t words = 0;
+            for (const auto &path : paths) {
+                matchWordsOnTrie(path, [&words](std::string_view,
+                                                std::string_view, float) {
+                    words++;
+                });
+            }
+            return words;
+        });
+
+        auto matchWords = [&dict](const std::vector<char> &data) {
+            size_t words = 0;
+            dict.matchWords(data.data(), data.size(),
+                            [&words](std::string_view, std::string_view,
+                                     float) {
+                                words++;
+                                return true;
+                            });
+            return words;
+        };
+        run(prefix + "/matchWords/full" + suffix,
+            [&matchWords, &encoded]() { return matchWords(encoded); });
+        const std::vector<char> initialsData(initials.begin(), initials.end());
+        run(prefix + "/matchWords/initials" + suffix,
+            [&matchWords, &initialsData]() {
+                return matchWords(initialsData);
+            });
+    }
+}
+
+// Compare matchPrefix on the packed formats, which are only used when the
+// dictionary is loaded from a file.
+void benchmarkPackedLookup(std::string_view name, JyutpingDictionary &dict) {
+    const auto path =
+        std::filesystem::temp_directory_path() / "libime-jyutping-packed.dict";
+    for (auto [format, formatName] :
+         {std::make_pair(JyutpingDictFormat::MappedBinary, "/v3"),
+          std::make_pair(JyutpingDictFormat::BlockCompressedBinary, "/v4")}) {
+        dict.save(JyutpingDictionary::SystemDict, path.c_str(), format);
+        JyutpingDictionary packed;
+        packed.load(JyutpingDictionary::SystemDict, path.c_str(),
+                    JyutpingDictFormat::Binary);
+        const auto prefix = std::string(name) + formatName;
+        for (auto n : inputLengths) {
+            std::string input;
+            for (size_t i = 0; i < n; i++) {
+                input.append(inputSyllables[i]);
+            }
+            const auto graph = JyutpingEncoder::parseUserJyutping(input);
+            run(prefix + "/matchPrefix/" + std::to_string(n),
+                [&packed, &graph]() {
+                    size_t words = 0;
+                    packed.matchPrefix(
+                        graph, [&words](const SegmentGraphPath &, WordNode &,
+                                        float,
+                                        std::unique_ptr<LatticeNodeData>) {
+                            words++;
+                            return true;
+                        });
+                    return words;
+                });
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+void benchmarkHasher() {
+    for (auto n : inputLengths) {
+        std::string input;
+        for (size_t i = 0; i < n; i++) {
+            input.append(inputSyllables[i]);
+        }
+        const auto graph = JyutpingEncoder::parseUserJyutping(input);
+        const auto path = syllablePath(graph, n);
+        const JyutpingSegmentGraphPathHasher hasher(graph);
+        const auto jyutpings = hasher.pathToJyutpings(path);
+        const auto suffix = "/" + std::to_string(n);
+        run("hasher/hash" + suffix,
+            [&hasher, &path]() { return hasher(path); });
+        run("hasher/equal" + suffix, [&hasher, &path, &jyutpings]() {
+            return static_cast<size_t>(hasher(path, jyutpings));
+        });
+        run("hasher/pathToJyutpings" + suffix, [&hasher, &path]() {
+            return hasher.pathToJyutpings(path).size();
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string dictFile = LIBIME_BINARY_DIR "/data/jyutping.dict";
+    size_t syntheticEntries = 5000000;
+    int opt;
+    while ((opt = getopt(argc, argv, "d:n:t:h")) != -1) {
+        switch (opt) {
+        case 'd':
+            dictFile = optarg;
+            break;
+        case 'n':
+            syntheticEntries = std::strtoul(optarg, nullptr, 10);
+            break;
+        case 't':
+            minTime = std::strtod(optarg, nullptr);
+            break;
+        case 'h':
+            usage(argv[0]);
+            return 0;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    benchmarkHasher();
+
+    {
+        // Unpack, so the dictionary is always kept in DATrie, even if the
+        // file is a mapped one.
+        JyutpingDictionary dict;
+        dict.load(JyutpingDictionary::SystemDict, dictFile.data(),
+                  JyutpingDictFormat::Binary);
+        dict.unpack(JyutpingDictionary::SystemDict);
+        benchmarkLoadSave("shipped", dict);
+        benchmarkLookup("shipped", dict);
+        benchmarkPackedLookup("shipped", dict);
+    }
+
+    if (syntheticEntries) {
+        const auto path = std::filesystem::temp_directory_path() /
+                          "libime-jyutping-benchmark.txt";
+        const auto bytes = writeSyntheticDictionary(path, syntheticEntries);
+        JyutpingDictionary dict;
+        runOnce("synthetic/loadTextParallel", syntheticEntries,
+                [&dict, &path, bytes]() {
+                    dict.loadTextParallel(JyutpingDictionary::SystemDict,
+                                          path.c_str());
+                    return bytes;
+                });
+        std::filesystem::remove(path);
+        benchmarkLoadSave("synthetic", dict);
+        benchmarkLookup("synthetic", dict);
+    }
+    return 0;
+}
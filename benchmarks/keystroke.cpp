@@ -0,0 +1,280 @@
+/*
+ * SPDX-FileCopyrightText: 2026~2026 CSSlayer <wengxt@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "libime/core/userlanguagemodel.h"
+#include "libime/jyutping/jyutpingcontext.h"
+#include "libime/jyutping/jyutpingdictionary.h"
+#include "libime/jyutping/jyutpingime.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace libime;
+using namespace libime::jyutping;
+
+namespace {
+
+// Time spent on a single keystroke. Stages are summed if the keystroke
+// triggers more than one update.
+struct Sample {
+    std::chrono::nanoseconds total{0};
+    JyutpingUpdateStats stats;
+    size_t allocations = 0;
+};
+
+// Number of heap allocations so far, counted by the replaced operator new.
+size_t allocationCount = 0;
+
+void usage(const char *argv0) {
+    std::cout << "Usage: " << argv0
+              << " [-d <dict>] [-l <model>] [-r <repeat>] [-o <output>] "
+                 "<log>..."
+              << std::endl
+              << "-d: Jyutping dictionary, default is the one in build tree"
+              << std::endl
+              << "-l: Language model, default is the one in build tree"
+              << std::endl
+              << "-r: Number of times to replay the logs, default is 1"
+              << std::endl
+              << "-o: Write JSON result to file instead of stdout"
+              << std::endl
+              << "-h: Show this help" << std::endl;
+}
+
+std::vector<std::vector<std::string>> readLog(const char *filename) {
+    std::ifstream in(filename);
+    if (!in) {
+        throw std::runtime_error(std::string("Failed to open ") + filename);
+    }
+    std::vector<std::vector<std::string>> sessions;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream tokens(line);
+        std::vector<std::string> session;
+        std::string token;
+        while (tokens >> token) {
+            session.push_back(std::move(token));
+        }
+        if (!session.empty()) {
+            sessions.push_back(std::move(session));
+        }
+    }
+    return sessions;
+}
+
+// Apply a single keystroke, returns false if the token is unknown.
+bool replay(JyutpingContext &c, const std::string &key) {
+    if (key == "back") {
+        c.backspace();
+    } else if (key == "reset") {
+        c.clear();
+    } else if (key == "left") {
+        if (c.cursor() > 0) {
+            c.setCursor(c.cursor() - 1);
+        }
+    } else if (key == "right") {
+        if (c.cursor() < c.size()) {
+            c.setCursor(c.cursor() + 1);
+        }
+    } else if (key == "home") {
+        c.setCursor(0);
+    } else if (key == "end") {
+        c.setCursor(c.size());
+    } else if (key.size() == 1 &&
+               (('a' <= key[0] && key[0] <= 'z') || key[0] == '\'')) {
+        c.type(key);
+    } else if (key.size() == 1 && ('0' <= key[0] && key[0] <= '9')) {
+        size_t idx = key[0] == '0' ? 9 : key[0] - '1';
+        if (idx < c.candidatesTo(idx + 1).size()) {
+            c.select(idx);
+        }
+        // Commit without learning, so every replay sees the same model.
+        if (c.selected()) {
+            c.clear();
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Write p50/p95/p99/max of value over all samples.
+template <typename T>
+void writeSummary(std::ostream &out, const char *name,
+                  std::vector<Sample> &samples, const T &value) {
+    std::sort(samples.begin(), samples.end(),
+              [&value](const Sample &lhs, const Sample &rhs) {
+                  return value(lhs) < value(rhs);
+              });
+    auto percentile = [&samples, &value](double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        auto rank = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+        return value(samples[rank]);
+    };
+    out << "    \"" << name << "\": {\"p50\": " << percentile(0.5)
+        << ", \"p95\": " << percentile(0.95)
+        << ", \"p99\": " << percentile(0.99)
+        << ", \"max\": " << percentile(1.0) << "}";
+}
+
+double micro(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    allocationCount++;
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char *argv[]) {
+    std::string dictFile = LIBIME_BINARY_DIR "/data/jyutping.dict";
+    std::string modelFile = LIBIME_BINARY_DIR "/data/zh_HK.lm";
+    std::string output;
+    size_t repeat = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "d:l:r:o:h")) != -1) {
+        switch (opt) {
+        case 'd':
+            dictFile = optarg;
+            break;
+        case 'l':
+            modelFile = optarg;
+            break;
+        case 'r':
+            repeat = std::max<size_t>(std::strtoul(optarg, nullptr, 10), 1);
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'h':
+            usage(argv[0]);
+            return 0;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::vector<std::string>> sessions;
+    for (int i = optind; i < argc; i++) {
+        auto log = readLog(argv[i]);
+        std::move(log.begin(), log.end(), std::back_inserter(sessions));
+    }
+
+    JyutpingIME ime(std::make_unique<JyutpingDictionary>(),
+                    std::make_unique<UserLanguageModel>(modelFile.data()));
+    ime.dict()->load(JyutpingDictionary::SystemDict, dictFile.data(),
+                     JyutpingDictFormat::Binary);
+    ime.setNBest(2);
+    ime.setScoreFilter(1.0f);
+    JyutpingContext c(&ime);
+
+    Sample current;
+    size_t updates = 0;
+    ime.setUpdateStatsCallback(
+        [&current, &updates](const JyutpingUpdateStats &stats) {
+            current.stats.parse += stats.parse;
+            current.stats.merge += stats.merge;
+            current.stats.decode += stats.decode;
+            current.stats.candidates += stats.candidates;
+            current.stats.match += stats.match;
+            updates++;
+        });
+
+    std::vector<Sample> samples;
+    for (size_t i = 0; i < repeat; i++) {
+        for (const auto &session : sessions) {
+            for (const auto &key : session) {
+                current = Sample();
+                const auto allocations = allocationCount;
+                auto start = std::chrono::steady_clock::now();
+                if (!replay(c, key)) {
+                    std::cerr << "Unknown keystroke: " << key << std::endl;
+                    return 1;
+                }
+                current.total = std::chrono::steady_clock::now() - start;
+                current.allocations = allocationCount - allocations;
+                samples.push_back(current);
+            }
+            c.clear();
+        }
+    }
+
+    std::ofstream fout;
+    if (!output.empty()) {
+        fout.open(output);
+        if (!fout) {
+            std::cerr << "Failed to open " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &out = output.empty() ? std::cout : fout;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n"
+        << "  \"keystrokes\": " << samples.size() << ",\n"
+        << "  \"updates\": " << updates << ",\n"
+        << "  \"unit\": \"us\",\n"
+        << "  \"latency\": {\n";
+    writeSummary(out, "total", samples,
+                 [](const Sample &sample) { return micro(sample.total); });
+    out << ",\n";
+    writeSummary(out, "parse", samples, [](const Sample &sample) {
+        return micro(sample.stats.parse);
+    });
+    out << ",\n";
+    writeSummary(out, "merge", samples, [](const Sample &sample) {
+        return micro(sample.stats.merge);
+    });
+    out << ",\n";
+    writeSummary(out, "decode", samples, [](const Sample &sample) {
+        return micro(sample.stats.decode);
+    });
+    out << ",\n";
+    writeSummary(out, "match", samples, [](const Sample &sample) {
+        return micro(sample.stats.match);
+    });
+    out << ",\n";
+    writeSummary(out, "candidates", samples, [](const Sample &sample) {
+        return micro(sample.stats.candidates);
+    });
+    out << "\n  },\n"
+        << "  \"allocations\": {\n"
+        << std::setprecision(0);
+    writeSummary(out, "total", samples, [](const Sample &sample) {
+        return static_cast<double>(sample.allocations);
+    });
+    out << "\n  }\n}\n";
+    return 0;
+}
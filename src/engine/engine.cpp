@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
@@ -44,6 +45,9 @@
 #include <fcitx/userinterface.h>
 #include <fcitx/userinterfacemanager.h>
 #include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <future>
 #include <istream>
 #include <libime/core/historybigram.h>
 #include <libime/core/languagemodel.h>
@@ -52,11 +56,17 @@
 #include <libime/jyutping/jyutpingcontext.h>
 #include <libime/jyutping/jyutpingdecoder.h>
 #include <libime/jyutping/jyutpingdictionary.h>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <quickphrase_public.h>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unistd.h>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -66,6 +76,7 @@ namespace fcitx {
 FCITX_DEFINE_LOG_CATEGORY(jyutping, "jyutping");
 
 #define PINYIN_DEBUG() FCITX_LOGC(jyutping, Debug)
+#define JYUTPING_ERROR() FCITX_LOGC(jyutping, Error)
 
 bool consumePreifx(std::string_view &view, std::string_view prefix) {
     if (boost::starts_with(view, prefix)) {
@@ -77,11 +88,13 @@ bool consumePreifx(std::string_view &view, std::string_view prefix) {
 
 class JyutpingState : public InputContextProperty {
 public:
-    JyutpingState(JyutpingEngine *engine) : context_(engine->ime()) {}
-
-    libime::jyutping::JyutpingContext context_;
+    // Created on the first key event, so creating the state doesn't wait for
+    // the IME to be loaded.
+    std::unique_ptr<libime::jyutping::JyutpingContext> context_;
     bool lastIsPunc_ = false;
     std::unique_ptr<EventSourceTime> cancelLastEvent_;
+    // Updates candidates once the keys already queued are handled.
+    std::unique_ptr<EventSource> updateEvent_;
 
     std::vector<std::string> predictWords_;
 };
@@ -141,7 +154,7 @@ public:
 
     void select(InputContext *inputContext) const override {
         auto *state = inputContext->propertyFor(&engine_->factory());
-        auto &context = state->context_;
+        auto &context = *state->context_;
         inputContext->commitString(context.selectedSentence() + word_);
         engine_->doReset(inputContext);
     }
@@ -158,8 +171,8 @@ public:
 
     void select(InputContext *inputContext) const override {
         auto *state = inputContext->propertyFor(&engine_->factory());
-        auto &context = state->context_;
-        if (idx_ >= context.candidates().size()) {
+        auto &context = *state->context_;
+        if (idx_ >= context.candidatesTo(idx_ + 1).size()) {
             return;
         }
         context.select(idx_);
@@ -170,6 +183,185 @@ public:
     size_t idx_;
 };
 
+// Shows candidates of the context page by page. Candidate words are only
+// built for the current page, and the context only materializes the
+// candidates up to the next page. Bulk access builds words and materializes
+// candidates only up to the requested one.
+class JyutpingCandidateList : public CandidateList,
+                              public PageableCandidateList,
+                              public CursorMovableCandidateList,
+                              public BulkCandidateList {
+public:
+    JyutpingCandidateList(JyutpingEngine *engine,
+                          libime::jyutping::JyutpingContext *context,
+                          int pageSize, const KeyList &selectionKeys,
+                          std::vector<std::string> spellWords)
+        : engine_(engine), context_(context),
+          pageSize_(static_cast<size_t>(std::max(pageSize, 1))),
+          spellWords_(std::move(spellWords)) {
+        setPageable(this);
+        setCursorMovable(this);
+        setBulk(this);
+        for (const auto &key : selectionKeys) {
+            labels_.emplace_back(Key::keySymToUTF8(key.sym()) + ". ");
+        }
+        buildPage();
+    }
+
+    const Text &label(int idx) const override {
+        static const Text emptyText;
+        if (idx < 0 || static_cast<size_t>(idx) >= labels_.size()) {
+            return emptyText;
+        }
+        return labels_[idx];
+    }
+
+    const CandidateWord &candidate(int idx) const override {
+        return *words_.at(idx);
+    }
+
+    int size() const override { return words_.size(); }
+
+    int cursorIndex() const override { return cursor_; }
+
+    CandidateLayoutHint layoutHint() const override {
+        return CandidateLayoutHint::NotSet;
+    }
+
+    bool hasPrev() const override { return page_ > 0; }
+
+    bool hasNext() const override {
+        auto nextStart = (page_ + 1) * pageSize_;
+        return available(nextStart + 1) > nextStart;
+    }
+
+    void prev() override {
+        if (!hasPrev()) {
+            return;
+        }
+        page_--;
+        buildPage();
+    }
+
+    void next() override {
+        if (!hasNext()) {
+            return;
+        }
+        page_++;
+        usedNextBefore_ = true;
+        buildPage();
+    }
+
+    bool usedNextBefore() const override { return usedNextBefore_; }
+
+    int currentPage() const override { return page_; }
+
+    void setPage(int page) override {
+        if (page < 0) {
+            return;
+        }
+        auto start = static_cast<size_t>(page) * pageSize_;
+        if (page != 0 && available(start + 1) <= start) {
+            return;
+        }
+        page_ = page;
+        buildPage();
+    }
+
+    const CandidateWord &candidateFromAll(int idx) const override {
+        if (idx < 0 || available(idx + 1) <= static_cast<size_t>(idx)) {
+            throw std::invalid_argument("invalid index");
+        }
+        if (allWords_.size() <= static_cast<size_t>(idx)) {
+            allWords_.resize(idx + 1);
+        }
+        auto &word = allWords_[idx];
+        if (!word) {
+            word = makeWord(idx);
+        }
+        return *word;
+    }
+
+    // Needs all the candidates, so only bulk users pay for it.
+    int totalSize() const override {
+        return available(std::numeric_limits<size_t>::max());
+    }
+
+    void prevCandidate() override {
+        if (cursor_ > 0) {
+            cursor_--;
+            return;
+        }
+        if (hasPrev()) {
+            page_--;
+        } else {
+            // Wrap around to the last candidate, this needs all of them.
+            page_ = (available(std::numeric_limits<size_t>::max()) - 1) /
+                    pageSize_;
+        }
+        buildPage();
+        cursor_ = size() - 1;
+    }
+
+    void nextCandidate() override {
+        if (cursor_ + 1 < size()) {
+            cursor_++;
+            return;
+        }
+        if (hasNext()) {
+            page_++;
+        } else {
+            page_ = 0;
+        }
+        buildPage();
+    }
+
+private:
+    // Candidates are the context ones, with spell words inserted after the
+    // first one.
+    size_t available(size_t n) const {
+        auto contextNeeded =
+            n > spellWords_.size() + 1 ? n - spellWords_.size() : 1;
+        auto total =
+            context_->candidatesTo(contextNeeded).size() + spellWords_.size();
+        return std::min(n, total);
+    }
+
+    // Word i of the list, it needs to be available.
+    std::unique_ptr<CandidateWord> makeWord(size_t i) const {
+        if (i >= 1 && i <= spellWords_.size()) {
+            return std::make_unique<SpellCandidateWord>(engine_,
+                                                        spellWords_[i - 1]);
+        }
+        auto idx = i == 0 ? 0 : i - spellWords_.size();
+        return std::make_unique<JyutpingCandidateWord>(
+            engine_, Text(context_->candidatesTo(idx + 1)[idx].toString()),
+            idx);
+    }
+
+    void buildPage() {
+        words_.clear();
+        cursor_ = 0;
+        auto start = page_ * pageSize_;
+        auto end = available(start + pageSize_);
+        for (auto i = start; i < end; i++) {
+            words_.push_back(makeWord(i));
+        }
+    }
+
+    JyutpingEngine *engine_;
+    libime::jyutping::JyutpingContext *context_;
+    size_t pageSize_;
+    std::vector<std::string> spellWords_;
+    std::vector<Text> labels_;
+    std::vector<std::unique_ptr<CandidateWord>> words_;
+    // Words built for bulk access, by the index in the whole list.
+    mutable std::vector<std::unique_ptr<CandidateWord>> allWords_;
+    size_t page_ = 0;
+    int cursor_ = 0;
+    bool usedNextBefore_ = false;
+};
+
 std::unique_ptr<CandidateList>
 JyutpingEngine::predictCandidateList(const std::vector<std::string> &words) {
     if (words.empty()) {
@@ -191,7 +383,7 @@ void JyutpingEngine::initPredict(InputContext *inputContext) {
     inputContext->inputPanel().reset();
 
     auto *state = inputContext->propertyFor(&factory_);
-    auto &context = state->context_;
+    auto &context = *state->context_;
     auto lmState = context.state();
     state->predictWords_ = context.selectedWords();
     auto words = prediction_.predict(lmState, context.selectedWords(),
@@ -259,7 +451,7 @@ void JyutpingEngine::updateUI(InputContext *inputContext) {
     inputContext->inputPanel().reset();
 
     auto state = inputContext->propertyFor(&factory_);
-    auto &context = state->context_;
+    auto &context = *state->context_;
     if (context.selected()) {
         auto sentence = context.sentence();
         if (!inputContext->capabilityFlags().testAny(
@@ -276,47 +468,54 @@ void JyutpingEngine::updateUI(InputContext *inputContext) {
         return;
     }
 
-    if (context.userInput().size()) {
-        const auto &candidates = context.candidates();
+    // A step pending from before this update is replaced, so a new key is
+    // never held up by the work left from the keys before it.
+    state->updateEvent_.reset();
+    // Update once the keys already queued are handled, candidates that ran
+    // out of time are continued then, one time limit per step. This still
+    // decodes on the main loop, it only lets queued keys share one decode.
+    if (context.hasPendingUpdate() || context.candidatesIncomplete()) {
+        auto ref = inputContext->watch();
+        state->updateEvent_ = instance_->eventLoop().addDeferEvent(
+            [this, ref](EventSource *) {
+                if (auto *inputContext = ref.get()) {
+                    auto *state = inputContext->propertyFor(&factory_);
+                    // Released when done, updateUI may need a new one.
+                    auto event = std::move(state->updateEvent_);
+                    state->context_->resumeUpdate();
+                    updateUI(inputContext);
+                }
+                return true;
+            });
+    }
+
+    if (context.hasPendingUpdate()) {
+        // Show the input as is until the candidates are updated.
         auto &inputPanel = inputContext->inputPanel();
-        if (context.candidates().size()) {
-            auto candidateList = std::make_unique<CommonCandidateList>();
-            size_t idx = 0;
-            candidateList->setPageSize(*config_.pageSize);
-            candidateList->setCursorPositionAfterPaging(
-                CursorPositionAfterPaging::ResetToFirst);
-
-            for (const auto &candidate : candidates) {
-                auto candidateString = candidate.toString();
-                candidateList->append<JyutpingCandidateWord>(
-                    this, Text(std::move(candidateString)), idx);
-                idx++;
-            }
+        auto selectedSentence = context.selectedSentence();
+        auto text = selectedSentence +
+                    context.userInput().substr(context.selectedLength());
+        inputPanel.setClientPreedit(Text(text, TextFormatFlag::Underline));
+        Text preedit(text);
+        preedit.setCursor(selectedSentence.size() + context.cursor() -
+                          context.selectedLength());
+        inputPanel.setPreedit(preedit);
+    } else if (context.userInput().size()) {
+        auto &inputPanel = inputContext->inputPanel();
+        if (context.candidatesTo(1).size()) {
+            std::vector<std::string> spellWords;
             int engNess;
             auto parsedPy =
                 context.preedit().substr(context.selectedSentence().size());
             if (spell() && (engNess = englishNess(parsedPy))) {
                 auto py = context.userInput().substr(context.selectedLength());
-                auto results = spell()->call<ISpell::hintWithProvider>(
+                spellWords = spell()->call<ISpell::hintWithProvider>(
                     "en", SpellProvider::Custom, py, engNess);
-                int idx = 1;
-                for (auto &result : results) {
-                    auto actualIdx = idx;
-                    if (actualIdx > candidateList->totalSize()) {
-                        actualIdx = candidateList->totalSize();
-                    }
-
-                    candidateList->insert(
-                        actualIdx,
-                        std::make_unique<SpellCandidateWord>(this, result));
-                    idx++;
-                }
             }
 
-            candidateList->setSelectionKey(selectionKeys_);
-            if (candidateList->size()) {
-                candidateList->setGlobalCursorIndex(0);
-            }
+            auto candidateList = std::make_unique<JyutpingCandidateList>(
+                this, &context, *config_.pageSize, selectionKeys_,
+                std::move(spellWords));
             inputPanel.setCandidateList(std::move(candidateList));
         }
         inputPanel.setClientPreedit(
@@ -350,27 +549,93 @@ void JyutpingEngine::updateUI(InputContext *inputContext) {
 
 JyutpingEngine::JyutpingEngine(Instance *instance)
     : instance_(instance),
-      factory_([this](InputContext &) { return new JyutpingState(this); }) {
-    ime_ = std::make_unique<libime::jyutping::JyutpingIME>(
-        std::make_unique<libime::jyutping::JyutpingDictionary>(),
-        std::make_unique<libime::UserLanguageModel>(
+      factory_([](InputContext &) { return new JyutpingState(); }) {
+    // Nothing needs the data until the first key event, so load it in the
+    // background instead of blocking the startup.
+    loadingIME_ = std::async(
+        std::launch::async,
+        [this]() -> std::unique_ptr<libime::jyutping::JyutpingIME> {
+            try {
+                return loadIME();
+            } catch (...) {
+                loadError_ = std::current_exception();
+            }
+            return nullptr;
+        });
+    reloadConfig();
+    saveDispatcher_.attach(&instance_->eventLoop());
+    instance_->inputContextManager().registerProperty("jyutpingState",
+                                                      &factory_);
+    KeySym syms[] = {
+        FcitxKey_1, FcitxKey_2, FcitxKey_3, FcitxKey_4, FcitxKey_5,
+        FcitxKey_6, FcitxKey_7, FcitxKey_8, FcitxKey_9, FcitxKey_0,
+    };
+
+    KeyStates states;
+    for (auto sym : syms) {
+        selectionKeys_.emplace_back(sym, states);
+    }
+
+    predictionAction_.setShortText(_("Prediction"));
+    predictionAction_.setLongText(_("Show prediction words"));
+    predictionAction_.setIcon(*config_.predictionEnabled
+                                  ? "fcitx-remind-active"
+                                  : "fcitx-remind-inactive");
+    predictionAction_.connect<SimpleAction::Activated>(
+        [this](InputContext *ic) {
+            config_.predictionEnabled.setValue(!(*config_.predictionEnabled));
+            predictionAction_.setIcon(*config_.predictionEnabled
+                                          ? "fcitx-remind-active"
+                                          : "fcitx-remind-inactive");
+            predictionAction_.update(ic);
+        });
+    instance_->userInterfaceManager().registerAction("jyutping-prediction",
+                                                     &predictionAction_);
+}
+
+JyutpingEngine::~JyutpingEngine() {
+    // The loader still refers to this engine.
+    if (loadingIME_.valid()) {
+        loadingIME_.wait();
+    }
+    finishBackgroundSave();
+}
+
+std::unique_ptr<libime::jyutping::JyutpingIME> JyutpingEngine::loadIME() {
+    // The language model is the largest part, load it along with the
+    // dictionaries.
+    auto model = std::async(std::launch::async, []() {
+        auto model = std::make_unique<libime::UserLanguageModel>(
             libime::DefaultLanguageModelResolver::instance()
-                .languageModelFileForLanguage("zh_HK")));
+                .languageModelFileForLanguage("zh_HK"));
+        auto file =
+            StandardPaths::global().open(StandardPathsType::PkgData,
+                                         "jyutping/user.history",
+                                         StandardPathsMode::User);
+        try {
+            IFDStreamBuf buffer(file.fd());
+            std::istream in(&buffer);
+            model->load(in);
+        } catch (const std::exception &) {
+        }
+        return model;
+    });
 
+    auto dict = std::make_unique<libime::jyutping::JyutpingDictionary>();
     const auto &standardPath = StandardPaths::global();
+    // Load by file name, so the dictionary can be memory mapped if it's in the
+    // mapped format.
     auto systemDictFile =
-        standardPath.open(StandardPathsType::Data, "libime/jyutping.dict");
-    if (systemDictFile.isValid()) {
-        IFDStreamBuf buffer(systemDictFile.fd());
-        std::istream in(&buffer);
-        ime_->dict()->load(libime::jyutping::JyutpingDictionary::SystemDict, in,
-                           libime::jyutping::JyutpingDictFormat::Binary);
+        standardPath.locate(StandardPathsType::Data, "libime/jyutping.dict");
+    if (!systemDictFile.empty()) {
+        dict->load(libime::jyutping::JyutpingDictionary::SystemDict,
+                   systemDictFile.c_str(),
+                   libime::jyutping::JyutpingDictFormat::Binary);
     } else {
-        ime_->dict()->load(libime::jyutping::JyutpingDictionary::SystemDict,
-                           LIBIME_JYUTPING_INSTALL_PKGDATADIR "/jyutping.dict",
-                           libime::jyutping::JyutpingDictFormat::Binary);
+        dict->load(libime::jyutping::JyutpingDictionary::SystemDict,
+                   LIBIME_JYUTPING_INSTALL_PKGDATADIR "/jyutping.dict",
+                   libime::jyutping::JyutpingDictFormat::Binary);
     }
-    prediction_.setUserLanguageModel(ime_->model());
 
     do {
         auto file =
@@ -384,62 +649,97 @@ JyutpingEngine::JyutpingEngine(Instance *instance)
         try {
             IFDStreamBuf buffer(file.fd());
             std::istream in(&buffer);
-            ime_->dict()->load(libime::jyutping::JyutpingDictionary::UserDict,
-                               in,
-                               libime::jyutping::JyutpingDictFormat::Binary);
+            dict->load(libime::jyutping::JyutpingDictionary::UserDict, in,
+                       libime::jyutping::JyutpingDictFormat::Binary);
         } catch (const std::exception &) {
         }
     } while (0);
     do {
-        auto file =
-            standardPath.open(StandardPathsType::PkgData,
-                              "jyutping/user.history", StandardPathsMode::User);
+        auto file = standardPath.open(StandardPathsType::PkgData,
+                                      "jyutping/user.dict.journal",
+                                      StandardPathsMode::User);
+
+        if (file.fd() < 0) {
+            break;
+        }
 
         try {
             IFDStreamBuf buffer(file.fd());
             std::istream in(&buffer);
-            ime_->model()->load(in);
+            userDictJournalSize_ = dict->loadJournal(
+                libime::jyutping::JyutpingDictionary::UserDict, in);
         } catch (const std::exception &) {
         }
     } while (0);
 
-    ime_->setScoreFilter(1);
-    reloadConfig();
-    instance_->inputContextManager().registerProperty("jyutpingState",
-                                                      &factory_);
-    KeySym syms[] = {
-        FcitxKey_1, FcitxKey_2, FcitxKey_3, FcitxKey_4, FcitxKey_5,
-        FcitxKey_6, FcitxKey_7, FcitxKey_8, FcitxKey_9, FcitxKey_0,
-    };
+    return std::make_unique<libime::jyutping::JyutpingIME>(std::move(dict),
+                                                           model.get());
+}
 
-    KeyStates states;
-    for (auto sym : syms) {
-        selectionKeys_.emplace_back(sym, states);
+libime::jyutping::JyutpingIME *JyutpingEngine::ime() {
+    if (ime_ || !loadingIME_.valid()) {
+        return ime_.get();
     }
 
-    predictionAction_.setShortText(_("Prediction"));
-    predictionAction_.setLongText(_("Show prediction words"));
-    predictionAction_.setIcon(*config_.predictionEnabled
-                                  ? "fcitx-remind-active"
-                                  : "fcitx-remind-inactive");
-    predictionAction_.connect<SimpleAction::Activated>(
-        [this](InputContext *ic) {
-            config_.predictionEnabled.setValue(!(*config_.predictionEnabled));
-            predictionAction_.setIcon(*config_.predictionEnabled
-                                          ? "fcitx-remind-active"
-                                          : "fcitx-remind-inactive");
-            predictionAction_.update(ic);
-        });
-    instance_->userInterfaceManager().registerAction("jyutping-prediction",
-                                                     &predictionAction_);
+    ime_ = loadingIME_.get();
+    if (!ime_) {
+        try {
+            std::rethrow_exception(loadError_);
+        } catch (const std::exception &e) {
+            JYUTPING_ERROR() << "Failed to load jyutping data: " << e.what();
+        } catch (...) {
+            JYUTPING_ERROR() << "Failed to load jyutping data.";
+        }
+        loadError_ = nullptr;
+        return nullptr;
+    }
+    prediction_.setUserLanguageModel(ime_->model());
+    ime_->setScoreFilter(1);
+    applyIMEConfig();
+    return ime_.get();
 }
 
-JyutpingEngine::~JyutpingEngine() {}
-
 void JyutpingEngine::reloadConfig() {
     readAsIni(config_, "conf/jyutping.conf");
+    // Applied once loaded otherwise.
+    if (ime_) {
+        applyIMEConfig();
+    }
+}
+
+void JyutpingEngine::applyIMEConfig() {
     ime_->setNBest(*config_.nbest);
     ime_->setInnerSegment(*config_.inner);
+    ime_->setNodeCacheSize(*config_.nodeCacheSize);
+    ime_->setMatchCacheSize(*config_.matchCacheSize);
+    ime_->setSharedMatchCacheSize(*config_.sharedMatchCacheSize);
+    ime_->setUpdateTimeLimit(
+        std::chrono::milliseconds(*config_.updateTimeLimit));
+    // Only collect stats when they can be logged, since collecting them is
+    // not free. Checked again on every reload, so that raising the log level
+    // takes effect with the next config reload.
+    if (jyutping().checkLogLevel(LogLevel::Debug)) {
+        ime_->setUpdateStatsCallback(
+            [](const libime::jyutping::JyutpingUpdateStats &stats) {
+                using Micro = std::chrono::microseconds;
+                auto micro = [](std::chrono::nanoseconds duration) {
+                    return std::chrono::duration_cast<Micro>(duration).count();
+                };
+                PINYIN_DEBUG()
+                    << "Update parse: " << micro(stats.parse)
+                    << "us merge: " << micro(stats.merge)
+                    << "us decode: " << micro(stats.decode)
+                    << "us (match: " << micro(stats.match)
+                    << "us) candidates: " << micro(stats.candidates)
+                    << "us paths: " << stats.paths
+                    << " trie positions: " << stats.triePositions
+                    << " words: " << stats.words
+                    << " candidates: " << stats.candidateCount
+                    << " duplicates: " << stats.duplicates;
+            });
+    } else {
+        ime_->setUpdateStatsCallback(nullptr);
+    }
 }
 void JyutpingEngine::activate(const fcitx::InputMethodEntry &,
                               fcitx::InputContextEvent &event) {
@@ -463,8 +763,8 @@ void JyutpingEngine::deactivate(const fcitx::InputMethodEntry &entry,
     auto *inputContext = event.inputContext();
     if (event.type() == EventType::InputContextSwitchInputMethod) {
         auto *state = inputContext->propertyFor(&factory_);
-        if (state->context_.size()) {
-            inputContext->commitString(state->context_.userInput());
+        if (state->context_ && state->context_->size()) {
+            inputContext->commitString(state->context_->userInput());
         }
     }
     reset(entry, event);
@@ -487,8 +787,24 @@ void JyutpingEngine::keyEvent(const InputMethodEntry &entry, KeyEvent &event) {
 
     auto *inputContext = event.inputContext();
     auto *state = inputContext->propertyFor(&factory_);
+    if (!state->context_) {
+        auto *ime = this->ime();
+        // Leave the key to others if the data failed to load.
+        if (!ime) {
+            return;
+        }
+        state->context_ =
+            std::make_unique<libime::jyutping::JyutpingContext>(ime);
+    }
     bool lastIsPunc = state->lastIsPunc_;
     state->lastIsPunc_ = false;
+    state->context_->setDeferUpdate(*config_.deferDecode);
+    // Only typing can be handled before candidates are updated.
+    if (state->context_->hasPendingUpdate() && !event.key().isLAZ() &&
+        !event.key().check(FcitxKey_apostrophe)) {
+        state->context_->updatePending();
+        updateUI(inputContext);
+    }
     // check if we can select candidate.
     auto candidateList = inputContext->inputPanel().candidateList();
     if (candidateList) {
@@ -554,73 +870,75 @@ void JyutpingEngine::keyEvent(const InputMethodEntry &entry, KeyEvent &event) {
     }
 
     if (event.key().isLAZ() ||
-        (event.key().check(FcitxKey_apostrophe) && state->context_.size())) {
+        (event.key().check(FcitxKey_apostrophe) && state->context_->size())) {
         // first v, use it to trigger quickphrase
         if (quickphrase() && event.key().check(FcitxKey_v) &&
-            !state->context_.size()) {
+            !state->context_->size()) {
 
             quickphrase()->call<IQuickPhrase::trigger>(
                 inputContext, "", "v", "", "", Key(FcitxKey_None));
             event.filterAndAccept();
             return;
         }
-        state->context_.type(Key::keySymToUTF8(event.key().sym()));
+        state->context_->type(Key::keySymToUTF8(event.key().sym()));
         event.filterAndAccept();
-    } else if (state->context_.size()) {
+    } else if (state->context_->size()) {
         // key to handle when it is not empty.
         if (event.key().check(FcitxKey_BackSpace)) {
-            if (state->context_.selectedLength()) {
-                state->context_.cancel();
+            if (state->context_->selectedLength()) {
+                state->context_->cancel();
             } else {
-                state->context_.backspace();
+                state->context_->backspace();
             }
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Delete)) {
-            state->context_.del();
+            state->context_->del();
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Home)) {
-            state->context_.setCursor(state->context_.selectedLength());
+            state->context_->setCursor(state->context_->selectedLength());
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_End)) {
-            state->context_.setCursor(state->context_.size());
+            state->context_->setCursor(state->context_->size());
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Left)) {
-            if (state->context_.cursor() == state->context_.selectedLength()) {
-                state->context_.cancel();
+            if (state->context_->cursor() ==
+                state->context_->selectedLength()) {
+                state->context_->cancel();
             }
-            auto cursor = state->context_.cursor();
+            auto cursor = state->context_->cursor();
             if (cursor > 0) {
-                state->context_.setCursor(cursor - 1);
+                state->context_->setCursor(cursor - 1);
             }
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Right)) {
-            auto cursor = state->context_.cursor();
-            if (cursor < state->context_.size()) {
-                state->context_.setCursor(cursor + 1);
+            auto cursor = state->context_->cursor();
+            if (cursor < state->context_->size()) {
+                state->context_->setCursor(cursor + 1);
             }
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Left, KeyState::Ctrl)) {
-            if (state->context_.cursor() == state->context_.selectedLength()) {
-                state->context_.cancel();
+            if (state->context_->cursor() ==
+                state->context_->selectedLength()) {
+                state->context_->cancel();
             }
-            auto cursor = state->context_.jyutpingBeforeCursor();
+            auto cursor = state->context_->jyutpingBeforeCursor();
             if (cursor >= 0) {
-                state->context_.setCursor(cursor);
+                state->context_->setCursor(cursor);
             }
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Right, KeyState::Ctrl)) {
-            auto cursor = state->context_.jyutpingAfterCursor();
+            auto cursor = state->context_->jyutpingAfterCursor();
             if (cursor >= 0 &&
-                static_cast<size_t>(cursor) <= state->context_.size()) {
-                state->context_.setCursor(cursor);
+                static_cast<size_t>(cursor) <= state->context_->size()) {
+                state->context_->setCursor(cursor);
             }
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Escape)) {
-            state->context_.clear();
+            state->context_->clear();
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_Return)) {
-            inputContext->commitString(state->context_.userInput());
-            state->context_.clear();
+            inputContext->commitString(state->context_->userInput());
+            state->context_->clear();
             event.filterAndAccept();
         } else if (event.key().check(FcitxKey_space)) {
             auto candidateList = inputContext->inputPanel().candidateList();
@@ -721,7 +1039,10 @@ void JyutpingEngine::reset(const InputMethodEntry &, InputContextEvent &event) {
 
 void JyutpingEngine::doReset(InputContext *inputContext) {
     auto *state = inputContext->propertyFor(&factory_);
-    state->context_.clear();
+    if (state->context_) {
+        state->context_->clear();
+    }
+    state->updateEvent_.reset();
     state->predictWords_.clear();
     inputContext->inputPanel().reset();
     inputContext->updatePreedit();
@@ -729,33 +1050,191 @@ void JyutpingEngine::doReset(InputContext *inputContext) {
     // state->lastIsPunc_ = false;
 }
 
+bool JyutpingEngine::appendUserDictJournal(bool ignoreLimit) {
+    auto *dict = ime_->dict();
+    const auto journalSize =
+        dict->journalSize(libime::jyutping::JyutpingDictionary::UserDict);
+    if (!ignoreLimit &&
+        userDictJournalSize_ + journalSize >= userDictJournalLimit) {
+        return false;
+    }
+    if (journalSize == 0) {
+        return true;
+    }
+    std::ofstream out(
+        StandardPaths::global().userDirectory(StandardPathsType::PkgData) /
+            "jyutping/user.dict.journal",
+        std::ios::out | std::ios::binary | std::ios::app);
+    if (!out) {
+        return false;
+    }
+    try {
+        dict->saveJournal(libime::jyutping::JyutpingDictionary::UserDict, out);
+        out.flush();
+    } catch (const std::exception &) {
+        return false;
+    }
+    if (!out) {
+        return false;
+    }
+    userDictJournalSize_ += journalSize;
+    return true;
+}
+
 void JyutpingEngine::save() {
     safeSaveAsIni(config_, "conf/jyutping.conf");
+    // Nothing can be changed before the data is used.
+    if (!ime_) {
+        return;
+    }
+    // Never write the files while the background save is running.
+    finishBackgroundSave();
+    if (*config_.backgroundSave) {
+        saveInBackground();
+        return;
+    }
     const auto &standardPath = StandardPaths::global();
-    standardPath.safeSave(
-        StandardPathsType::PkgData, "jyutping/user.dict", [this](int fd) {
-            OFDStreamBuf buffer(fd);
-            std::ostream out(&buffer);
-            try {
-                ime_->dict()->save(
-                    libime::jyutping::JyutpingDictionary::UserDict, out,
-                    libime::jyutping::JyutpingDictFormat::Binary);
-                return static_cast<bool>(out);
-            } catch (const std::exception &) {
-                return false;
+    // Only learned words are appended to the journal, the user dictionary is
+    // saved as a whole once the journal grows too large. A failed append is
+    // followed by a full save, which covers the words in the partial write.
+    if (!appendUserDictJournal()) {
+        if (standardPath.safeSave(
+                StandardPathsType::PkgData, "jyutping/user.dict",
+                [this](int fd) {
+                    OFDStreamBuf buffer(fd);
+                    std::ostream out(&buffer);
+                    try {
+                        ime_->dict()->save(
+                            libime::jyutping::JyutpingDictionary::UserDict,
+                            out, libime::jyutping::JyutpingDictFormat::Binary);
+                        return static_cast<bool>(out);
+                    } catch (const std::exception &) {
+                        return false;
+                    }
+                })) {
+            userDictSaved(std::numeric_limits<size_t>::max());
+        } else {
+            JYUTPING_ERROR() << "Failed to save user dictionary.";
+        }
+    }
+    if (!standardPath.safeSave(StandardPathsType::PkgData,
+                               "jyutping/user.history", [this](int fd) {
+                                   OFDStreamBuf buffer(fd);
+                                   std::ostream out(&buffer);
+                                   try {
+                                       ime_->model()->save(out);
+                                       return true;
+                                   } catch (const std::exception &) {
+                                       return false;
+                                   }
+                               })) {
+        JYUTPING_ERROR() << "Failed to save user history.";
+    }
+}
+
+void JyutpingEngine::userDictSaved(size_t journalSize) {
+    // Everything in the journal is in the new snapshot now.
+    if (StandardPaths::global().safeSave(StandardPathsType::PkgData,
+                                         "jyutping/user.dict.journal",
+                                         [](int) { return true; })) {
+        ime_->dict()->clearJournal(
+            libime::jyutping::JyutpingDictionary::UserDict, journalSize);
+        userDictJournalSize_ = 0;
+        return;
+    }
+    // The old journal is replayed on top of the new snapshot when loading.
+    // Words learned after it need to follow it in the file, otherwise their
+    // older costs in the journal would win.
+    JYUTPING_ERROR() << "Failed to clear user dictionary journal.";
+    if (!appendUserDictJournal(true)) {
+        JYUTPING_ERROR() << "Failed to append user dictionary journal.";
+    }
+}
+
+void JyutpingEngine::saveInBackground() {
+    // Take the snapshots here, writing them is left to the thread. The
+    // journal file is not touched until the thread is done.
+    //
+    // Copying the user dictionary is linear in its size and still done on
+    // the event loop. It only happens when the journal is full, once every
+    // userDictJournalLimit learned words, other saves only append to the
+    // journal.
+    std::optional<libime::jyutping::JyutpingTrie> userDict;
+    if (!appendUserDictJournal()) {
+        userDict = ime_->dict()->snapshot(
+            libime::jyutping::JyutpingDictionary::UserDict);
+    }
+    std::string history;
+    try {
+        std::ostringstream out;
+        ime_->model()->save(out);
+        history = std::move(out).str();
+    } catch (const std::exception &e) {
+        JYUTPING_ERROR() << "Failed to save user history: " << e.what();
+    }
+
+    saveResult_ = BackgroundSaveResult();
+    saveResult_.saveDict = userDict.has_value();
+    saveResult_.saveHistory = !history.empty();
+    saveResult_.journalSize = ime_->dict()->journalSize(
+        libime::jyutping::JyutpingDictionary::UserDict);
+    const auto generation = ++saveGeneration_;
+    saveThread_ = std::thread([this, userDict = std::move(userDict),
+                               history = std::move(history),
+                               generation]() mutable {
+        const auto &standardPath = StandardPaths::global();
+        if (userDict) {
+            saveResult_.dictSaved = standardPath.safeSave(
+                StandardPathsType::PkgData, "jyutping/user.dict",
+                [&userDict](int fd) {
+                    OFDStreamBuf buffer(fd);
+                    std::ostream out(&buffer);
+                    try {
+                        libime::jyutping::JyutpingDictionary::saveSnapshot(
+                            *userDict, out,
+                            libime::jyutping::JyutpingDictFormat::Binary);
+                        out.flush();
+                        return static_cast<bool>(out) && fsync(fd) == 0;
+                    } catch (const std::exception &) {
+                        return false;
+                    }
+                });
+        }
+        if (!history.empty()) {
+            saveResult_.historySaved = standardPath.safeSave(
+                StandardPathsType::PkgData, "jyutping/user.history",
+                [&history](int fd) {
+                    OFDStreamBuf buffer(fd);
+                    std::ostream out(&buffer);
+                    out.write(history.data(), history.size());
+                    out.flush();
+                    return static_cast<bool>(out) && fsync(fd) == 0;
+                });
+        }
+        saveDispatcher_.schedule([this, generation]() {
+            // Already finished by a later save.
+            if (generation == saveGeneration_) {
+                finishBackgroundSave();
             }
         });
-    standardPath.safeSave(StandardPathsType::PkgData, "jyutping/user.history",
-                          [this](int fd) {
-                              OFDStreamBuf buffer(fd);
-                              std::ostream out(&buffer);
-                              try {
-                                  ime_->model()->save(out);
-                                  return true;
-                              } catch (const std::exception &) {
-                                  return false;
-                              }
-                          });
+    });
+}
+
+void JyutpingEngine::finishBackgroundSave() {
+    if (!saveThread_.joinable()) {
+        return;
+    }
+    saveThread_.join();
+    if (saveResult_.saveDict) {
+        if (saveResult_.dictSaved) {
+            userDictSaved(saveResult_.journalSize);
+        } else {
+            JYUTPING_ERROR() << "Failed to save user dictionary.";
+        }
+    }
+    if (saveResult_.saveHistory && !saveResult_.historySaved) {
+        JYUTPING_ERROR() << "Failed to save user history.";
+    }
 }
 } // namespace fcitx
 
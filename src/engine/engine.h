@@ -9,6 +9,7 @@
 
 #include <fcitx-config/configuration.h>
 #include <fcitx-config/iniparser.h>
+#include <fcitx-utils/eventdispatcher.h>
 #include <fcitx-utils/i18n.h>
 #include <fcitx/action.h>
 #include <fcitx/addonfactory.h>
@@ -18,7 +19,12 @@
 #include <fcitx/instance.h>
 #include <libime/core/prediction.h>
 #include <libime/jyutping/jyutpingime.h>
+#include <libime/jyutping/jyutpingmatchstate.h>
+#include <cstdint>
+#include <exception>
+#include <future>
 #include <memory>
+#include <thread>
 
 namespace fcitx {
 
@@ -58,7 +64,27 @@ FCITX_CONFIGURATION(
     Option<int, IntConstrain> nbest{this, "Number of sentence",
                                     _("Number of Sentences"), 2,
                                     IntConstrain(1, 3)};
-    Option<bool> inner{this, "InnerSegment", _("Use Inner Segment"), true};);
+    Option<bool> inner{this, "InnerSegment", _("Use Inner Segment"), true};
+    Option<bool> backgroundSave{this, "BackgroundSave",
+                                _("Save User Data in Background"), false};
+    Option<bool> deferDecode{this, "DeferDecode",
+                             _("Update Candidates After Pending Keys"), false};
+    Option<int, IntConstrain> updateTimeLimit{
+        this, "UpdateTimeLimit",
+        _("Time Limit of Updating Candidates in Milliseconds (0 to disable)"),
+        0, IntConstrain(0, 1000)};
+    Option<int, IntConstrain> nodeCacheSize{
+        this, "NodeCacheSize", _("Syllable Match Cache Size"),
+        libime::jyutping::JyutpingMatchState::cacheSizeDefault,
+        IntConstrain(1, 100000)};
+    Option<int, IntConstrain> matchCacheSize{
+        this, "MatchCacheSize", _("Word Match Cache Size"),
+        libime::jyutping::JyutpingMatchState::cacheSizeDefault,
+        IntConstrain(1, 100000)};
+    Option<int, IntConstrain> sharedMatchCacheSize{
+        this, "SharedMatchCacheSize",
+        _("Word Match Cache Size Shared by All Windows (0 to disable)"), 0,
+        IntConstrain(0, 100000)};);
 
 class JyutpingState;
 class EventSourceTime;
@@ -88,7 +114,9 @@ public:
         reloadConfig();
     }
 
-    libime::jyutping::JyutpingIME *ime() { return ime_.get(); }
+    // Waits for the data if it's still loading. Returns nullptr if loading
+    // failed, the error is logged once.
+    libime::jyutping::JyutpingIME *ime();
 
     void initPredict(InputContext *ic);
     void updatePredict(InputContext *ic);
@@ -97,13 +125,48 @@ public:
     void updateUI(InputContext *inputContext);
 
 private:
+    // Words in the user dictionary journal before it's compacted into a full
+    // save.
+    static constexpr size_t userDictJournalLimit = 1000;
+
+    // Runs on a worker thread.
+    std::unique_ptr<libime::jyutping::JyutpingIME> loadIME();
+    void applyIMEConfig();
+    bool appendUserDictJournal(bool ignoreLimit = false);
+    // Called when the user dictionary is saved as a whole, with the number
+    // of journal words included.
+    void userDictSaved(size_t journalSize);
+    void saveInBackground();
+    // Wait for the background save and report the result.
+    void finishBackgroundSave();
+
+    // Written by the save thread, only read after it's joined.
+    struct BackgroundSaveResult {
+        bool saveDict = false;
+        bool dictSaved = false;
+        bool saveHistory = false;
+        bool historySaved = false;
+        size_t journalSize = 0;
+    };
+
     Instance *instance_;
     JyutpingEngineConfig config_;
+    // Null until the data loaded by loadingIME_ is used.
     std::unique_ptr<libime::jyutping::JyutpingIME> ime_;
+    std::future<std::unique_ptr<libime::jyutping::JyutpingIME>> loadingIME_;
+    // Set by the loader if loading failed.
+    std::exception_ptr loadError_;
     KeyList selectionKeys_;
     FactoryFor<JyutpingState> factory_;
     SimpleAction predictionAction_;
     libime::Prediction prediction_;
+    // Words in the journal file.
+    size_t userDictJournalSize_ = 0;
+    EventDispatcher saveDispatcher_;
+    std::thread saveThread_;
+    BackgroundSaveResult saveResult_;
+    // Tells whether a finished save is already handled.
+    uint64_t saveGeneration_ = 0;
 
     FCITX_ADDON_DEPENDENCY_LOADER(quickphrase, instance_->addonManager());
     FCITX_ADDON_DEPENDENCY_LOADER(chttrans, instance_->addonManager());
@@ -9,11 +9,15 @@
 #include "jyutpingencoder.h"
 #include "jyutpingime.h"
 #include "jyutpingmatchstate.h"
+#include "jyutpingmatchstate_p.h"
 #include "libime/core/historybigram.h"
 #include "libime/core/userlanguagemodel.h"
 #include <algorithm>
+#include <chrono>
 #include <fcitx-utils/log.h>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
 
 namespace libime {
 namespace jyutping {
@@ -27,6 +31,44 @@ struct SelectedJyutping {
     std::string encodedJyutping_;
 };
 
+// A word candidate that is not materialized as SentenceResult yet.
+struct PendingCandidate {
+    const LatticeNode *node_;
+    float adjust_;
+    float score_;
+    // Position in collection order, breaks ties of score_.
+    size_t order_;
+    // Words not starting from bos are duplicates if their full word is one of
+    // the first dupLimit_ words in dup_, i.e. the ones collected before them.
+    // Words starting from bos are checked when they are collected, and have 0.
+    size_t dupLimit_;
+};
+
+// Measures the stages of JyutpingContext::update, only reads the clock if
+// enabled.
+class UpdateStatsTimer {
+public:
+    explicit UpdateStatsTimer(bool enabled) : enabled_(enabled) {
+        if (enabled_) {
+            last_ = clock::now();
+        }
+    }
+
+    void mark(std::chrono::nanoseconds &stage) {
+        if (!enabled_) {
+            return;
+        }
+        auto now = clock::now();
+        stage = now - last_;
+        last_ = now;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+    bool enabled_;
+    clock::time_point last_;
+};
+
 class JyutpingContextPrivate {
 public:
     JyutpingContextPrivate(JyutpingContext *q, JyutpingIME *ime)
@@ -35,11 +77,69 @@ public:
     std::vector<std::vector<SelectedJyutping>> selected_;
 
     JyutpingIME *ime_;
+    JyutpingIncrementalParser parser_;
     SegmentGraph segs_;
     Lattice lattice_;
     JyutpingMatchState matchState_;
-    std::vector<SentenceResult> candidates_;
     std::vector<fcitx::ScopedConnection> conn_;
+    bool deferUpdate_ = false;
+    bool updatePending_ = false;
+    // Dictionary matching of last update ran out of time.
+    bool incomplete_ = false;
+    // Ignore JyutpingIME::updateTimeLimit in the update.
+    bool noTimeLimit_ = false;
+
+    // Materialize candidates until there are at least n of them, or no
+    // more pending ones.
+    void materialize(size_t n) const {
+        if (candidates_.size() >= n || pendingBegin_ == pending_.size()) {
+            return;
+        }
+        auto begin = pending_.begin() + pendingBegin_;
+        auto batch = std::max(n - candidates_.size(), materializeBatchSize);
+        auto middle =
+            begin + std::min<size_t>(batch, pending_.size() - pendingBegin_);
+        std::partial_sort(begin, middle, pending_.end(),
+                          [](const PendingCandidate &lhs,
+                             const PendingCandidate &rhs) {
+                              if (lhs.score_ != rhs.score_) {
+                                  return lhs.score_ > rhs.score_;
+                              }
+                              return lhs.order_ < rhs.order_;
+                          });
+        for (auto iter = begin; iter != middle; ++iter) {
+            if (iter->dupLimit_) {
+                auto dup = dup_.find(iter->node_->fullWord());
+                if (dup != dup_.end() && dup->second < iter->dupLimit_) {
+                    continue;
+                }
+            }
+            candidates_.push_back(
+                iter->node_->toSentenceResult(iter->adjust_));
+        }
+        pendingBegin_ = middle - pending_.begin();
+        // Whole batch might be duplicates.
+        materialize(n);
+    }
+
+    void clearCandidates() {
+        candidates_.clear();
+        pending_.clear();
+        pendingBegin_ = 0;
+        dup_.clear();
+    }
+
+    // Materialized candidates, followed by pending_[pendingBegin_:]. Pending
+    // ones point to lattice_ so they are only valid until next update.
+    mutable std::vector<SentenceResult> candidates_;
+    mutable std::vector<PendingCandidate> pending_;
+    mutable size_t pendingBegin_ = 0;
+    // Words of candidates that are checked against by pending ones, mapped to
+    // the order they are collected in.
+    std::unordered_map<std::string, size_t> dup_;
+
+    // Number of candidates sorted at once, enough for a page or two.
+    static constexpr size_t materializeBatchSize = 20;
 };
 
 JyutpingContext::JyutpingContext(JyutpingIME *ime)
@@ -75,10 +175,13 @@ void JyutpingContext::erase(size_t from, size_t to) {
     // check if erase everything
     if (from == 0 && to >= size()) {
         FCITX_D();
-        d->candidates_.clear();
+        d->clearCandidates();
+        d->updatePending_ = false;
+        d->incomplete_ = false;
         d->selected_.clear();
         d->lattice_.clear();
         d->matchState_.clear();
+        d->parser_.reset();
         d->segs_ = SegmentGraph();
     } else {
         cancelTill(from);
@@ -106,6 +209,7 @@ int JyutpingContext::jyutpingBeforeCursor() const {
         return -1;
     }
     c -= len;
+    d->materialize(1);
     if (d->candidates_.size()) {
         for (auto &s : d->candidates_[0].sentence()) {
             for (auto iter = s->path().begin(),
@@ -129,6 +233,7 @@ int JyutpingContext::jyutpingAfterCursor() const {
         return -1;
     }
     c -= len;
+    d->materialize(1);
     if (d->candidates_.size()) {
         for (auto &s : d->candidates_[0].sentence()) {
             for (auto iter = s->path().begin(),
@@ -146,11 +251,20 @@ int JyutpingContext::jyutpingAfterCursor() const {
 
 const std::vector<SentenceResult> &JyutpingContext::candidates() const {
     FCITX_D();
+    d->materialize(std::numeric_limits<size_t>::max());
+    return d->candidates_;
+}
+
+const std::vector<SentenceResult> &
+JyutpingContext::candidatesTo(size_t n) const {
+    FCITX_D();
+    d->materialize(n);
     return d->candidates_;
 }
 
 void JyutpingContext::select(size_t idx) {
     FCITX_D();
+    d->materialize(idx + 1);
     assert(idx < d->candidates_.size());
 
     auto offset = selectedLength();
@@ -214,13 +328,18 @@ State JyutpingContext::state() const {
 
 void JyutpingContext::update() {
     FCITX_D();
+    d->updatePending_ = false;
     if (size() == 0) {
         clear();
         return;
     }
 
     if (selected()) {
-        d->candidates_.clear();
+        d->clearCandidates();
+    } else if (d->deferUpdate_) {
+        // Candidates don't match the input anymore.
+        d->clearCandidates();
+        d->updatePending_ = true;
     } else {
         size_t start = 0;
         auto model = d->ime_->model();
@@ -239,8 +358,20 @@ void JyutpingContext::update() {
                 }
             }
         }
-        SegmentGraph newGraph = JyutpingEncoder::parseUserJyutping(
-            userInput().substr(start), d->ime_->innerSegment());
+        auto *matchState = d->matchState_.d_func();
+        const auto timeLimit = d->noTimeLimit_
+                                   ? std::chrono::microseconds::zero()
+                                   : d->ime_->updateTimeLimit();
+        matchState->deadline_ =
+            timeLimit.count()
+                ? std::chrono::steady_clock::now() + timeLimit
+                : std::chrono::steady_clock::time_point::max();
+        const auto &statsCallback = d->ime_->updateStatsCallback();
+        JyutpingUpdateStats stats;
+        UpdateStatsTimer timer(static_cast<bool>(statsCallback));
+        SegmentGraph newGraph = d->parser_.parse(userInput().substr(start),
+                                                 d->ime_->innerSegment());
+        timer.mark(stats.parse);
         d->segs_.merge(
             newGraph,
             [d](const std::unordered_set<const SegmentGraphNode *> &nodes) {
@@ -248,24 +379,30 @@ void JyutpingContext::update() {
                 d->matchState_.discardNode(nodes);
             });
         assert(d->segs_.checkGraph());
+        timer.mark(stats.merge);
 
         auto &graph = d->segs_;
 
+        matchState->stats_ = statsCallback ? &stats : nullptr;
+        matchState->timedOut_ = false;
         d->ime_->decoder()->decode(d->lattice_, d->segs_, d->ime_->nbest(),
                                    state, d->ime_->maxDistance(),
                                    d->ime_->minPath(), d->ime_->beamSize(),
                                    d->ime_->frameSize(), &d->matchState_);
+        matchState->stats_ = nullptr;
+        d->incomplete_ = matchState->timedOut_;
+        timer.mark(stats.decode);
 
-        d->candidates_.clear();
-        std::unordered_set<std::string> dup;
+        // Only sentences are materialized here, words are collected and
+        // materialized by the callers on demand.
+        d->clearCandidates();
         for (size_t i = 0, e = d->lattice_.sentenceSize(); i < e; i++) {
             d->candidates_.push_back(d->lattice_.sentence(i));
-            dup.insert(d->candidates_.back().toString());
+            d->dup_.emplace(d->candidates_.back().toString(), d->dup_.size());
         }
 
         auto bos = &graph.start();
 
-        auto beginSize = d->candidates_.size();
         for (size_t i = graph.size(); i > 0; i--) {
             float min = 0;
             float max = -std::numeric_limits<float>::max();
@@ -283,12 +420,15 @@ void JyutpingContext::update() {
                                 max = latticeNode.score();
                             }
                         }
-                        if (dup.count(latticeNode.word())) {
+                        if (!d->dup_
+                                 .emplace(latticeNode.word(), d->dup_.size())
+                                 .second) {
+                            stats.duplicates++;
                             continue;
                         }
-                        d->candidates_.push_back(
-                            latticeNode.toSentenceResult(adjust));
-                        dup.insert(latticeNode.word());
+                        d->pending_.push_back({&latticeNode, adjust,
+                                               latticeNode.score() + adjust,
+                                               d->pending_.size(), 0});
                     }
                 }
             }
@@ -299,18 +439,20 @@ void JyutpingContext::update() {
                     if (latticeNode.from() != bos &&
                         latticeNode.score() > min &&
                         latticeNode.score() + d->ime_->maxDistance() > max) {
-                        auto fullWord = latticeNode.fullWord();
-                        if (dup.count(fullWord)) {
-                            continue;
-                        }
-                        d->candidates_.push_back(
-                            latticeNode.toSentenceResult(adjust));
+                        // Same as the bos words, only those of this length
+                        // and longer ones are checked against.
+                        d->pending_.push_back(
+                            {&latticeNode, adjust, latticeNode.score() + adjust,
+                             d->pending_.size(), d->dup_.size()});
                     }
                 }
             }
         }
-        std::sort(d->candidates_.begin() + beginSize, d->candidates_.end(),
-                  std::greater<SentenceResult>());
+        timer.mark(stats.candidates);
+        stats.candidateCount = d->candidates_.size() + d->pending_.size();
+        if (statsCallback) {
+            statsCallback(stats);
+        }
     }
 
     if (cursor() < selectedLength()) {
@@ -369,6 +511,7 @@ std::pair<std::string, size_t> JyutpingContext::preeditWithCursor() const {
 
     auto resultSize = ss.size();
 
+    d->materialize(1);
     if (d->candidates_.size()) {
         bool first = true;
         for (auto &s : d->candidates_[0].sentence()) {
@@ -429,6 +572,7 @@ std::string JyutpingContext::selectedFullJyutping() const {
 
 std::string JyutpingContext::candidateFullJyutping(size_t idx) const {
     FCITX_D();
+    d->materialize(idx + 1);
     std::string jyutping;
     for (auto &p : d->candidates_[idx].sentence()) {
         if (!p->word().empty()) {
@@ -507,5 +651,65 @@ JyutpingIME *JyutpingContext::ime() const {
     return d->ime_;
 }
 
+const JyutpingMatchState &JyutpingContext::matchState() const {
+    FCITX_D();
+    return d->matchState_;
+}
+
+void JyutpingContext::setDeferUpdate(bool defer) {
+    FCITX_D();
+    d->deferUpdate_ = defer;
+    if (!defer) {
+        updatePending();
+    }
+}
+
+bool JyutpingContext::deferUpdate() const {
+    FCITX_D();
+    return d->deferUpdate_;
+}
+
+bool JyutpingContext::candidatesIncomplete() const {
+    FCITX_D();
+    return d->incomplete_;
+}
+
+bool JyutpingContext::hasPendingUpdate() const {
+    FCITX_D();
+    return d->updatePending_;
+}
+
+void JyutpingContext::updatePending() {
+    FCITX_D();
+    if (!d->updatePending_) {
+        return;
+    }
+    auto defer = std::exchange(d->deferUpdate_, false);
+    update();
+    d->deferUpdate_ = defer;
+}
+
+void JyutpingContext::resumeUpdate() {
+    FCITX_D();
+    if (!d->incomplete_ && !d->updatePending_) {
+        return;
+    }
+    auto defer = std::exchange(d->deferUpdate_, false);
+    update();
+    d->deferUpdate_ = defer;
+}
+
+void JyutpingContext::completeUpdate() {
+    FCITX_D();
+    if (!d->incomplete_ && !d->updatePending_) {
+        return;
+    }
+    auto defer = std::exchange(d->deferUpdate_, false);
+    d->noTimeLimit_ = true;
+    update();
+    d->noTimeLimit_ = false;
+    d->deferUpdate_ = defer;
+}
+
 } // namespace jyutping
 } // namespace libime
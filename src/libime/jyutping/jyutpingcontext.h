@@ -11,6 +11,7 @@
 #include <libime/core/inputbuffer.h>
 #include <libime/core/lattice.h>
 #include <libime/jyutping/jyutpingime.h>
+#include <libime/jyutping/jyutpingmatchstate.h>
 #include <vector>
 
 namespace libime {
@@ -26,14 +27,23 @@ public:
     void erase(size_t from, size_t to) override;
     void setCursor(size_t pos) override;
 
+    /// \brief All candidates of current input.
+    ///
+    /// Candidates are materialized on demand, this materializes all of them.
     const std::vector<SentenceResult> &candidates() const;
+    /// \brief Candidates with at least the first n materialized.
+    ///
+    /// The returned list may be longer than n, and is shorter only if there
+    /// are no more candidates. Use this if only a page of candidates is
+    /// needed.
+    const std::vector<SentenceResult> &candidatesTo(size_t n) const;
     void select(size_t idx);
     void cancel();
     bool cancelTill(size_t pos);
 
     bool selected() const;
     std::string sentence() const {
-        auto &c = candidates();
+        auto &c = candidatesTo(1);
         if (c.size()) {
             return selectedSentence() + c[0].toString();
         } else {
@@ -58,6 +68,41 @@ public:
 
     JyutpingIME *ime() const;
 
+    const JyutpingMatchState &matchState() const;
+
+    /// \brief Whether the last update ran out of JyutpingIME::updateTimeLimit.
+    ///
+    /// Input that is not matched in time has no words in the lattice, so
+    /// candidates may miss most of the input or even be empty in that case.
+    /// What is matched already is kept, resumeUpdate(), completeUpdate() or
+    /// the next update continue from where the matching stopped.
+    bool candidatesIncomplete() const;
+
+    /// \brief Continue updating candidates with a new
+    /// JyutpingIME::updateTimeLimit, if they are incomplete or an update is
+    /// pending.
+    ///
+    /// Each call matches at least one more segment of the input, so calling
+    /// it until candidatesIncomplete() is false always finishes.
+    void resumeUpdate();
+
+    /// \brief Update candidates without JyutpingIME::updateTimeLimit, if
+    /// they are incomplete or an update is pending.
+    void completeUpdate();
+
+    /// \brief Whether to postpone updating candidates after edits.
+    ///
+    /// If enabled, an edit only drops the candidates and marks an update as
+    /// pending, which is done by updatePending(). Edits made in between share
+    /// a single decode. This only coalesces edits, the decode still runs on
+    /// the thread calling updatePending(). Disabled by default.
+    void setDeferUpdate(bool defer);
+    bool deferUpdate() const;
+    bool hasPendingUpdate() const;
+
+    /// \brief Update candidates now if an update is pending.
+    void updatePending();
+
     State state() const;
 
 protected:
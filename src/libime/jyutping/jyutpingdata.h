@@ -10,8 +10,11 @@
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index_container.hpp>
+#include <cstdint>
 #include <libime/jyutping/jyutpingencoder.h>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -44,6 +47,31 @@ private:
     bool fuzzy_;
 };
 
+struct JyutpingSyllableEntry {
+    std::string_view jyutping;
+    JyutpingInitial initial;
+    JyutpingFinal final;
+    bool fuzzy = false;
+};
+
+// A final that need to be matched after an initial, and the number of fuzzy
+// steps it adds to the match.
+struct JyutpingFinalExpansion {
+    JyutpingFinal final;
+    uint8_t fuzzies;
+};
+
+struct JyutpingSyllableExpansion {
+    JyutpingInitial initial;
+    std::span<const JyutpingFinalExpansion> finals;
+};
+
+struct JyutpingInnerSegment {
+    std::string_view jyutping;
+    std::string_view first;
+    std::string_view second;
+};
+
 using JyutpingMap = boost::multi_index_container<
     JyutpingEntry,
     boost::multi_index::indexed_by<boost::multi_index::hashed_non_unique<
@@ -51,10 +79,28 @@ using JyutpingMap = boost::multi_index_container<
                                           &JyutpingEntry::jyutpingView>,
         JyutpingHash>>>;
 
+// Look up a syllable in the static syllable table, which doesn't allocate.
+// Returns nullptr if jyutping is not a valid syllable.
+LIBIMEJYUTPING_EXPORT const JyutpingSyllableEntry *
+findJyutpingSyllable(std::string_view jyutping);
+
+// Expand a user input segment, which is either a full syllable or an
+// initial, to all initial and final combinations that need to be matched on
+// the trie. An initial is expanded to all its valid finals. The expansion is
+// computed once for all segments. Returns an empty span if the segment is
+// neither a syllable nor an initial.
+LIBIMEJYUTPING_EXPORT std::span<const JyutpingSyllableExpansion>
+getSyllableExpansion(std::string_view jyutping);
+
 LIBIMEJYUTPING_EXPORT
 const JyutpingMap &getJyutpingMap();
 LIBIMEJYUTPING_EXPORT const std::vector<bool> &getEncodedInitialFinal();
 
+// Look up how a syllable can be split into two inner segments, e.g. "ceoi"
+// to "ce" and "oi". Returns nullptr if jyutping can't be split.
+LIBIMEJYUTPING_EXPORT const JyutpingInnerSegment *
+findInnerSegment(std::string_view jyutping);
+
 LIBIMEJYUTPING_EXPORT const
     std::unordered_map<std::string, std::pair<std::string, std::string>> &
     getInnerSegment();
@@ -6,132 +6,88 @@
  */
 
 #include "jyutpingdictionary.h"
+#include "jyutpingcontext.h"
+#include "jyutpingdata.h"
 #include "jyutpingdecoder_p.h"
+#include "jyutpingdictionary_p.h"
 #include "jyutpingencoder.h"
+#include "jyutpingime.h"
+#include "jyutpingime_p.h"
 #include "jyutpingmatchstate_p.h"
+#include "jyutpingpackedtrie_p.h"
 #include "libime/core/datrie.h"
 #include "libime/core/lattice.h"
 #include "libime/core/lrucache.h"
 #include "utils_p.h"
 #include "zstdfilter.h"
 #include <boost/algorithm/string.hpp>
+#include <boost/crc.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/unordered_map.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <istream>
+#include <iterator>
 #include <queue>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string_view>
+#include <thread>
 #include <utility>
 
 namespace libime {
 namespace jyutping {
 
-static const float fuzzyCost = std::log10(0.5f);
 static const float invalidJyutpingCost = -100.0f;
-static const char jyutpingHanziSep = '\x01';
 
 static constexpr uint32_t jyutpingBinaryFormatMagic = 0x000fc733;
 static constexpr uint32_t jyutpingBinaryFormatVersion = 0x2;
-
-struct JyutpingSegmentGraphPathHasher {
-    JyutpingSegmentGraphPathHasher(const SegmentGraph &graph) : graph_(graph) {}
-
-    // Generate a "|" separated raw jyutping string from given path, skip all
-    // separator.
-    std::string pathToJyutpings(const SegmentGraphPath &path) const {
-        std::string result;
-        result.reserve(path.size() + path.back()->index() -
-                       path.front()->index() + 1);
-        const auto &data = graph_.data();
-        auto iter = path.begin();
-        while (iter + 1 < path.end()) {
-            auto begin = (*iter)->index();
-            auto end = (*std::next(iter))->index();
-            iter++;
-            if (data[begin] == '\'') {
-                continue;
-            }
-            while (begin < end) {
-                result.push_back(data[begin]);
-                begin++;
-            }
-            result.push_back('|');
-        }
-        return result;
-    }
-
-    // Generate hash for path but avoid allocate the string.
-    size_t operator()(const SegmentGraphPath &path) const {
-        if (path.size() <= 1) {
-            return 0;
-        }
-        boost::hash<char> hasher;
-
-        size_t seed = 0;
-        const auto &data = graph_.data();
-        auto iter = path.begin();
-        while (iter + 1 < path.end()) {
-            auto begin = (*iter)->index();
-            auto end = (*std::next(iter))->index();
-            iter++;
-            if (data[begin] == '\'') {
-                continue;
-            }
-            while (begin < end) {
-                boost::hash_combine(seed, hasher(data[begin]));
-                begin++;
-            }
-            boost::hash_combine(seed, hasher('|'));
-        }
-        return seed;
-    }
-
-    // Check equality of jyutping string and the path. The string s should be
-    // equal to pathToJyutpings(path), but this function just try to avoid
-    // allocate a string for comparisin.
-    bool operator()(const SegmentGraphPath &path, const std::string &s) const {
-        if (path.size() <= 1) {
-            return false;
-        }
-        auto is = s.begin();
-        const auto &data = graph_.data();
-        auto iter = path.begin();
-        while (iter + 1 < path.end() && is != s.end()) {
-            auto begin = (*iter)->index();
-            auto end = (*std::next(iter))->index();
-            iter++;
-            if (data[begin] == '\'') {
-                continue;
-            }
-            while (begin < end && is != s.end()) {
-                if (*is != data[begin]) {
-                    return false;
-                }
-                is++;
-                begin++;
-            }
-            if (begin != end) {
-                return false;
-            }
-
-            if (is == s.end() || *is != '|') {
-                return false;
-            }
-            is++;
-        }
-        return iter + 1 == path.end() && is == s.end();
-    }
-
-private:
-    const SegmentGraph &graph_;
+static constexpr uint32_t jyutpingMappedBinaryFormatVersion = 0x3;
+static constexpr uint32_t jyutpingBlockCompressedBinaryFormatVersion = 0x4;
+static constexpr uint32_t jyutpingJournalMagic = 0x000fc734;
+static constexpr uint32_t jyutpingJournalVersion = 0x3;
+// Packed trie data follows the magic and version.
+static constexpr size_t jyutpingPackedTrieOffset =
+    sizeof(jyutpingBinaryFormatMagic) +
+    sizeof(jyutpingMappedBinaryFormatVersion);
+// Keys are short, anything longer is from a corrupted journal.
+static constexpr uint32_t jyutpingJournalMaxKeySize = 4096;
+// Magic, version, count, byte length and checksum of the records.
+static constexpr size_t jyutpingJournalHeaderSize = 5 * sizeof(uint32_t);
+
+// A change recorded in the journal.
+enum class JournalOp : uint32_t { Add = 0, Remove = 1, Clear = 2 };
+
+struct JournalEntry {
+    JournalOp op;
+    // Encoded key and cost of the word, unused by Clear.
+    std::string key;
+    float cost = 0.0f;
 };
 
+// Build the trie key of a word into key, reusing its buffer.
+static void encodeWordKey(std::string &key, std::string_view fullJyutping,
+                          std::string_view hanzi) {
+    key.resize(JyutpingEncoder::encodedFullJyutpingSize(fullJyutping));
+    key.resize(JyutpingEncoder::encodeFullJyutping(fullJyutping, key.data(),
+                                                   key.size()));
+    key.push_back(jyutpingHanziSep);
+    key.append(hanzi);
+}
+
 struct SegmentGraphNodeGreater {
     bool operator()(const SegmentGraphNode *lhs,
                     const SegmentGraphNode *rhs) const {
@@ -153,6 +109,23 @@ const SegmentGraphNode *prevIsSeparator(const SegmentGraph &graph,
     return nullptr;
 }
 
+// Estimated size of a cache entry.
+static size_t cachedSize(const std::string &jyutpings,
+                         const MatchedJyutpingTrieNodes &nodes) {
+    return jyutpings.size() + sizeof(nodes) +
+           nodes.triePositions_.size() * sizeof(JyutpingTriePosition);
+}
+
+static size_t cachedSize(const std::string &jyutpings,
+                         const std::vector<JyutpingMatchResult> &results) {
+    size_t bytes = jyutpings.size() + sizeof(results);
+    for (const auto &result : results) {
+        bytes += sizeof(result) + result.word_.word().size() +
+                 result.encodedJyutping_.size();
+    }
+    return bytes;
+}
+
 class JyutpingMatchContext {
 public:
     explicit JyutpingMatchContext(
@@ -162,14 +135,29 @@ public:
         : graph_(graph), hasher_(graph), callback_(callback), ignore_(ignore),
           matchedPathsMap_(&matchState->d_func()->matchedPaths_),
           nodeCacheMap_(&matchState->d_func()->nodeCacheMap_),
-          matchCacheMap_(&matchState->d_func()->matchCacheMap_) {}
+          matchCacheMap_(&matchState->d_func()->matchCacheMap_),
+          nodeCacheStats_(&matchState->d_func()->nodeCacheStats_),
+          matchCacheStats_(&matchState->d_func()->matchCacheStats_),
+          scratch_(&matchState->d_func()->scratch_),
+          stats_(matchState->d_func()->stats_),
+          deadline_(matchState->d_func()->deadline_),
+          timedOut_(&matchState->d_func()->timedOut_) {
+        if (auto *context = matchState->d_func()->context_) {
+            wordLimit_ = context->ime()->wordLimit();
+            nodeCacheSize_ = context->ime()->nodeCacheSize();
+            matchCacheSize_ = context->ime()->matchCacheSize();
+            sharedMatchCache_ = &context->ime()->d_func()->sharedMatchCache_;
+            model_ = context->ime()->model();
+        }
+    }
 
     explicit JyutpingMatchContext(
         const SegmentGraph &graph, const GraphMatchCallback &callback,
         const std::unordered_set<const SegmentGraphNode *> &ignore,
-        NodeToMatchedJyutpingPathsMap &matchedPaths)
+        NodeToMatchedJyutpingPathsMap &matchedPaths,
+        JyutpingMatchScratch &scratch)
         : graph_(graph), hasher_(graph), callback_(callback), ignore_(ignore),
-          matchedPathsMap_(&matchedPaths) {}
+          matchedPathsMap_(&matchedPaths), scratch_(&scratch) {}
 
     FCITX_INLINE_DEFINE_DEFAULT_DTOR_AND_COPY(JyutpingMatchContext);
 
@@ -181,12 +169,61 @@ public:
     NodeToMatchedJyutpingPathsMap *matchedPathsMap_;
     JyutpingTrieNodeCache *nodeCacheMap_ = nullptr;
     JyutpingMatchResultCache *matchCacheMap_ = nullptr;
+    JyutpingMatchCacheStats *nodeCacheStats_ = nullptr;
+    JyutpingMatchCacheStats *matchCacheStats_ = nullptr;
+    size_t nodeCacheSize_ = JyutpingMatchState::cacheSizeDefault;
+    size_t matchCacheSize_ = JyutpingMatchState::cacheSizeDefault;
+    JyutpingSharedMatchCache *sharedMatchCache_ = nullptr;
+    const UserLanguageModel *model_ = nullptr;
+    JyutpingMatchScratch *scratch_;
+    // Null if stats are not collected.
+    JyutpingUpdateStats *stats_ = nullptr;
+    std::chrono::steady_clock::time_point deadline_ =
+        std::chrono::steady_clock::time_point::max();
+    bool *timedOut_ = nullptr;
+    size_t wordLimit_ = 0;
 };
 
 class JyutpingDictionaryPrivate : fcitx::QPtrHolder<JyutpingDictionary> {
 public:
     JyutpingDictionaryPrivate(JyutpingDictionary *q)
-        : fcitx::QPtrHolder<JyutpingDictionary>(q) {}
+        : fcitx::QPtrHolder<JyutpingDictionary>(q) {
+        conn_ = q->connect<JyutpingDictionary::dictSizeChanged>(
+            [this](size_t size) {
+                if (packedTries_.size() > size) {
+                    packedTries_.resize(size);
+                }
+                if (journals_.size() > size) {
+                    journals_.resize(size);
+                }
+            });
+    }
+
+    std::vector<JournalEntry> &journal(size_t idx) {
+        if (journals_.size() <= idx) {
+            journals_.resize(idx + 1);
+        }
+        return journals_[idx];
+    }
+
+    JyutpingTrieRef trie(size_t idx) const {
+        FCITX_Q();
+        return {q->trie(idx), packedTrie(idx)};
+    }
+
+    const JyutpingPackedTrie *packedTrie(size_t idx) const {
+        return idx < packedTries_.size() ? packedTries_[idx].get() : nullptr;
+    }
+
+    void setPackedTrie(size_t idx, std::unique_ptr<JyutpingPackedTrie> trie) {
+        if (packedTries_.size() <= idx) {
+            if (!trie) {
+                return;
+            }
+            packedTries_.resize(idx + 1);
+        }
+        packedTries_[idx] = std::move(trie);
+    }
 
     void addEmptyMatch(const JyutpingMatchContext &context,
                        const SegmentGraphNode &currentNode,
@@ -198,12 +235,20 @@ public:
                             MatchedJyutpingPaths &currentMatches) const;
 
     bool matchWords(const JyutpingMatchContext &context,
-                    const MatchedJyutpingPaths &newPaths) const;
+                    std::span<const MatchedJyutpingPath> newPaths) const;
     bool matchWordsForOnePath(const JyutpingMatchContext &context,
                               const MatchedJyutpingPath &path) const;
 
-    void matchNode(const JyutpingMatchContext &context,
+    // Returns false if the node has been matched already.
+    bool matchNode(const JyutpingMatchContext &context,
                    const SegmentGraphNode &currentNode) const;
+
+    // Tries loaded from the packed format, the corresponding DATrie is kept
+    // empty.
+    std::vector<std::unique_ptr<JyutpingPackedTrie>> packedTries_;
+    // Changes made since the journal is cleared.
+    std::vector<std::vector<JournalEntry>> journals_;
+    fcitx::ScopedConnection conn_;
 };
 
 void JyutpingDictionaryPrivate::addEmptyMatch(
@@ -223,98 +268,12 @@ void JyutpingDictionaryPrivate::addEmptyMatch(
 
         vec.push_back(&currentNode);
         for (size_t i = 0; i < q->dictSize(); i++) {
-            auto &trie = *q->trie(i);
-            currentMatches.emplace_back(&trie, 0, vec);
+            currentMatches.emplace_back(trie(i), 0, vec);
             currentMatches.back().triePositions().emplace_back(0, 0);
         }
     }
 }
 
-JyutpingTriePositions
-traverseAlongPathOneStepBySyllables(const MatchedJyutpingPath &path,
-                                    const MatchedJyutpingSyllables &syls) {
-    JyutpingTriePositions positions;
-    for (const auto &pr : path.triePositions()) {
-        uint64_t _pos;
-        size_t fuzzies;
-        std::tie(_pos, fuzzies) = pr;
-        for (auto &syl : syls) {
-            // make a copy
-            auto pos = _pos;
-            auto initial = static_cast<char>(syl.first);
-            auto result = path.trie()->traverse(&initial, 1, pos);
-            if (JyutpingTrie::isNoPath(result)) {
-                continue;
-            }
-            const auto &finals = syl.second;
-
-            auto updateNext = [fuzzies, &path,
-                               &positions](char final, int fuzzy, auto pos) {
-                auto result = path.trie()->traverse(&final, 1, pos);
-
-                if (!JyutpingTrie::isNoPath(result)) {
-                    size_t newFuzzies = fuzzies + fuzzy;
-                    positions.emplace_back(pos, newFuzzies);
-                }
-            };
-            if (finals.size() > 1 ||
-                finals[0].first != JyutpingFinal::Invalid) {
-                for (auto final : finals) {
-                    updateNext(static_cast<char>(final.first), 0, pos);
-                }
-            } else {
-                // Assign a different factory for "m" and "ng", since these
-                // character can only be matched with "m" or "ng".
-                int fuzzyFactor = JyutpingEncoder::isValidInitialFinal(
-                                      syl.first, JyutpingFinal::Zero)
-                                      ? 10
-                                      : 1;
-                for (char test = JyutpingEncoder::firstFinal;
-                     test <= JyutpingEncoder::lastFinal; test++) {
-                    auto curFinal = static_cast<JyutpingFinal>(test);
-                    if (JyutpingEncoder::isValidInitialFinal(syl.first,
-                                                             curFinal)) {
-                        updateNext(
-                            test,
-                            (curFinal == JyutpingFinal::Zero ? 0 : fuzzyFactor),
-                            pos);
-                    }
-                }
-            }
-        }
-    }
-    return positions;
-}
-
-template <typename T>
-void matchWordsOnTrie(const MatchedJyutpingPath &path, const T &callback) {
-    const char sep = jyutpingHanziSep;
-    for (auto &pr : path.triePositions()) {
-        uint64_t pos;
-        size_t fuzzies;
-        std::tie(pos, fuzzies) = pr;
-        float extraCost = fuzzies * fuzzyCost;
-        auto result = path.trie()->traverse(&sep, 1, pos);
-        if (JyutpingTrie::isNoPath(result)) {
-            continue;
-        }
-
-        path.trie()->foreach(
-            [&path, &callback, extraCost](JyutpingTrie::value_type value,
-                                          size_t len, uint64_t pos) {
-                std::string s;
-                s.reserve(len + path.size() * 2 + 1);
-                path.trie()->suffix(s, len + path.size() * 2 + 1, pos);
-                std::string_view view(s);
-                auto encodedJyutping = view.substr(0, path.size() * 2);
-                auto hanzi = view.substr(path.size() * 2 + 1);
-                callback(encodedJyutping, hanzi, value + extraCost);
-                return true;
-            },
-            pos);
-    }
-}
-
 bool JyutpingDictionaryPrivate::matchWordsForOnePath(
     const JyutpingMatchContext &context,
     const MatchedJyutpingPath &path) const {
@@ -322,22 +281,60 @@ bool JyutpingDictionaryPrivate::matchWordsForOnePath(
     assert(path.path_.size() >= 2);
     const SegmentGraphNode &prevNode = *path.path_[path.path_.size() - 2];
     if (context.matchCacheMap_) {
-        auto &matchCache = (*context.matchCacheMap_)[path.trie()];
-        auto result =
+        auto &matchCache =
+            context.matchCacheMap_
+                ->try_emplace(path.trie().key(), context.matchCacheSize_)
+                .first->second;
+        // The private cache is checked first, it needs neither a lock nor
+        // building the jyutping string of the path.
+        auto *result =
             matchCache.find(path.path_, context.hasher_, context.hasher_);
-        if (!result) {
-            result =
-                matchCache.insert(context.hasher_.pathToJyutpings(path.path_));
-            result->clear();
-
-            auto &items = *result;
-            matchWordsOnTrie(path, [&items](std::string_view encodedJyutping,
-                                            std::string_view hanzi,
-                                            float cost) {
-                items.emplace_back(hanzi, cost, encodedJyutping);
-            });
+        if (result) {
+            context.matchCacheStats_->hits++;
+        } else {
+            FCITX_Q();
+            context.matchCacheStats_->misses++;
+            auto jyutpings = context.hasher_.pathToJyutpings(path.path_);
+            auto *sharedCache =
+                path.trie().key() == q->trie(JyutpingDictionary::SystemDict)
+                    ? context.sharedMatchCache_
+                    : nullptr;
+            JyutpingMatchResults results;
+            if (sharedCache) {
+                results = sharedCache->find(jyutpings);
+            }
+            if (!results) {
+                auto items =
+                    std::make_shared<std::vector<JyutpingMatchResult>>();
+                matchWordsOnTrie(
+                    path,
+                    [&items](std::string_view encodedJyutping,
+                             std::string_view hanzi, float cost) {
+                        items->emplace_back(hanzi, cost, encodedJyutping);
+                    },
+                    context.wordLimit_);
+                if (sharedCache) {
+                    // Decoder fills the word index of a cached word if it is
+                    // missing, do it before other threads can see it.
+                    for (auto &item : *items) {
+                        item.word_.setIdx(
+                            context.model_->index(item.word_.word()));
+                    }
+                    sharedCache->insert(jyutpings, items);
+                }
+                results = std::move(items);
+            }
+            if (matchCache.size() >= matchCache.capacity()) {
+                context.matchCacheStats_->evictions++;
+            }
+            const size_t bytes = cachedSize(jyutpings, *results);
+            result = matchCache.insert(jyutpings, std::move(results), bytes,
+                                       *context.matchCacheStats_);
         }
-        for (auto &item : *result) {
+        if (context.stats_) {
+            context.stats_->words += result->value()->size();
+        }
+        for (auto &item : *result->value()) {
             context.callback_(path.path_, item.word_, item.value_,
                               std::make_unique<JyutpingLatticeNodePrivate>(
                                   item.encodedJyutping_));
@@ -347,18 +344,24 @@ bool JyutpingDictionaryPrivate::matchWordsForOnePath(
             }
         }
     } else {
-        matchWordsOnTrie(path, [&matched, &path, &context,
-                                &prevNode](std::string_view encodedJyutping,
-                                           std::string_view hanzi, float cost) {
-            WordNode word(hanzi, InvalidWordIndex);
-            context.callback_(
-                path.path_, word, cost,
-                std::make_unique<JyutpingLatticeNodePrivate>(encodedJyutping));
-            if (path.size() == 1 &&
-                path.path_[path.path_.size() - 2] == &prevNode) {
-                matched = true;
-            }
-        });
+        matchWordsOnTrie(
+            path,
+            [&matched, &path, &context,
+             &prevNode](std::string_view encodedJyutping,
+                        std::string_view hanzi, float cost) {
+                if (context.stats_) {
+                    context.stats_->words++;
+                }
+                WordNode word(hanzi, InvalidWordIndex);
+                context.callback_(path.path_, word, cost,
+                                  std::make_unique<JyutpingLatticeNodePrivate>(
+                                      encodedJyutping));
+                if (path.size() == 1 &&
+                    path.path_[path.path_.size() - 2] == &prevNode) {
+                    matched = true;
+                }
+            },
+            context.wordLimit_);
     }
 
     return matched;
@@ -366,7 +369,7 @@ bool JyutpingDictionaryPrivate::matchWordsForOnePath(
 
 bool JyutpingDictionaryPrivate::matchWords(
     const JyutpingMatchContext &context,
-    const MatchedJyutpingPaths &newPaths) const {
+    std::span<const MatchedJyutpingPath> newPaths) const {
     bool matched = false;
     for (const auto &path : newPaths) {
         matched |= matchWordsForOnePath(context, path);
@@ -400,50 +403,71 @@ void JyutpingDictionaryPrivate::findMatchesBetween(
         return;
     }
 
-    const auto syls = JyutpingEncoder::stringToSyllables(jyutping);
+    const auto syls = getSyllableExpansion(jyutping);
     const MatchedJyutpingPaths &prevMatchedPaths = matchedPathsMap[&prevNode];
-    MatchedJyutpingPaths newPaths;
+    auto &positions = context.scratch_->positions_;
+    auto &segmentPath = context.scratch_->segmentPath_;
+    // New paths are appended to currentMatches directly, starting from here.
+    const size_t newPathsBegin = currentMatches.size();
     for (auto &path : prevMatchedPaths) {
-        // Make a copy of path so we can modify based on it.
-        auto segmentPath = path.path_;
+        segmentPath.assign(path.path_.begin(), path.path_.end());
         segmentPath.push_back(&currentNode);
 
         if (context.nodeCacheMap_) {
-            auto &nodeCache = (*context.nodeCacheMap_)[path.trie()];
+            auto &nodeCache =
+                context.nodeCacheMap_
+                    ->try_emplace(path.trie().key(), context.nodeCacheSize_)
+                    .first->second;
             auto p =
                 nodeCache.find(segmentPath, context.hasher_, context.hasher_);
             std::shared_ptr<MatchedJyutpingTrieNodes> result;
             if (!p) {
+                context.nodeCacheStats_->misses++;
                 result = std::make_shared<MatchedJyutpingTrieNodes>(
                     path.trie(), path.size() + 1);
-                nodeCache.insert(context.hasher_.pathToJyutpings(segmentPath),
-                                 result);
-                result->triePositions_ =
-                    traverseAlongPathOneStepBySyllables(path, syls);
+                traverseAlongPathOneStepBySyllables(path, syls, positions);
+                result->triePositions_.assign(positions.begin(),
+                                              positions.end());
+                if (nodeCache.size() >= nodeCache.capacity()) {
+                    context.nodeCacheStats_->evictions++;
+                }
+                auto jyutpings = context.hasher_.pathToJyutpings(segmentPath);
+                const size_t bytes = cachedSize(jyutpings, *result);
+                nodeCache.insert(jyutpings, result, bytes,
+                                 *context.nodeCacheStats_);
             } else {
-                result = *p;
+                context.nodeCacheStats_->hits++;
+                result = p->value();
                 assert(result->size_ == path.size() + 1);
             }
 
             if (result->triePositions_.size()) {
-                newPaths.emplace_back(result, segmentPath);
+                currentMatches.emplace_back(result, segmentPath);
             }
         } else {
-            // make an empty one
-            newPaths.emplace_back(path.trie(), path.size() + 1, segmentPath);
-
-            newPaths.back().result_->triePositions_ =
-                traverseAlongPathOneStepBySyllables(path, syls);
-            // if there's nothing, pop it.
-            if (!newPaths.back().triePositions().size()) {
-                newPaths.pop_back();
+            traverseAlongPathOneStepBySyllables(path, syls, positions);
+            // Only create a path if there's something.
+            if (positions.size()) {
+                currentMatches.emplace_back(path.trie(), path.size() + 1,
+                                            segmentPath);
+                currentMatches.back().triePositions().assign(
+                    positions.begin(), positions.end());
             }
         }
     }
 
+    if (context.stats_) {
+        for (size_t i = newPathsBegin; i < currentMatches.size(); i++) {
+            context.stats_->paths++;
+            context.stats_->triePositions +=
+                currentMatches[i].triePositions().size();
+        }
+    }
+
     if (!context.ignore_.count(&currentNode)) {
         // after we match current syllable, we first try to match word.
-        if (!matchWords(context, newPaths)) {
+        if (!matchWords(context,
+                        std::span(currentMatches).subspan(newPathsBegin))) {
             // If we failed to match any length 1 word, add a new empty word
             // to make lattice connect together.
             SegmentGraphPath vec;
@@ -457,18 +481,15 @@ void JyutpingDictionaryPrivate::findMatchesBetween(
             context.callback_(vec, word, invalidJyutpingCost, nullptr);
         }
     }
-
-    std::move(newPaths.begin(), newPaths.end(),
-              std::back_inserter(currentMatches));
 }
 
-void JyutpingDictionaryPrivate::matchNode(
+bool JyutpingDictionaryPrivate::matchNode(
     const JyutpingMatchContext &context,
     const SegmentGraphNode &currentNode) const {
     auto &matchedPathsMap = *context.matchedPathsMap_;
     // Check if the node has been searched already.
     if (matchedPathsMap.count(&currentNode)) {
-        return;
+        return false;
     }
     auto &currentMatches = matchedPathsMap[&currentNode];
     // To create a new start.
@@ -478,6 +499,7 @@ void JyutpingDictionaryPrivate::matchNode(
     for (auto &prevNode : currentNode.prevs()) {
         findMatchesBetween(context, prevNode, currentNode, currentMatches);
     }
+    return true;
 }
 
 void JyutpingDictionary::matchPrefixImpl(
@@ -487,11 +509,13 @@ void JyutpingDictionary::matchPrefixImpl(
     FCITX_D();
 
     NodeToMatchedJyutpingPathsMap localMatchedPaths;
+    JyutpingMatchScratch localScratch;
     JyutpingMatchContext context =
         helper
             ? JyutpingMatchContext{graph, callback, ignore,
                                    static_cast<JyutpingMatchState *>(helper)}
-            : JyutpingMatchContext{graph, callback, ignore, localMatchedPaths};
+            : JyutpingMatchContext{graph, callback, ignore, localMatchedPaths,
+                                   localScratch};
 
     // A queue to make sure that node with smaller index will be visted first
     // because we want to make sure every predecessor node are visited before
@@ -502,11 +526,31 @@ void JyutpingDictionary::matchPrefixImpl(
                             SegmentGraphNodeGreater>;
     SegmentGraphNodeQueue q;
 
+    std::chrono::steady_clock::time_point begin;
+    if (context.stats_) {
+        begin = std::chrono::steady_clock::now();
+    }
+
     auto &start = graph.start();
     q.push(&start);
 
+    const bool hasDeadline =
+        context.deadline_ != std::chrono::steady_clock::time_point::max();
+    // At least one node is matched before the deadline is checked, so a
+    // match resumed with a short deadline still makes progress.
+    bool matched = false;
     while (!q.empty()) {
         auto currentNode = q.top();
+        // Nodes left get no words, so the decoder likely can't reach the end
+        // through them. Nodes matched so far are kept in the match state, so
+        // the caller can resume from here with another deadline. Only checked
+        // before a node not matched yet, which the queue may hold copies of.
+        if (hasDeadline && matched &&
+            !context.matchedPathsMap_->count(currentNode) &&
+            std::chrono::steady_clock::now() >= context.deadline_) {
+            *context.timedOut_ = true;
+            break;
+        }
         q.pop();
 
         // Push successors into the queue.
@@ -514,78 +558,219 @@ void JyutpingDictionary::matchPrefixImpl(
             q.push(&node);
         }
 
-        d->matchNode(context, *currentNode);
+        if (d->matchNode(context, *currentNode)) {
+            matched = true;
+        }
+    }
+
+    if (context.stats_) {
+        context.stats_->match += std::chrono::steady_clock::now() - begin;
     }
 }
 
+namespace {
+
+// Trie positions of all dictionaries after traversing some encoded jyutping.
+using JyutpingTrieFrontier =
+    std::vector<std::pair<JyutpingTrieRef, JyutpingTrie::position_type>>;
+
+// Finals that can follow an initial, which a final wildcard expands to.
+std::span<const char> validFinals(char initial) {
+    static const auto table = []() {
+        std::array<std::vector<char>, JyutpingEncoder::lastInitial + 1> table;
+        for (char i = JyutpingEncoder::firstInitial;
+             i <= JyutpingEncoder::lastInitial; i++) {
+            for (char f = JyutpingEncoder::firstFinal;
+                 f <= JyutpingEncoder::lastFinal; f++) {
+                if (JyutpingEncoder::isValidInitialFinal(
+                        static_cast<JyutpingInitial>(i),
+                        static_cast<JyutpingFinal>(f))) {
+                    table[i].push_back(f);
+                }
+            }
+        }
+        return table;
+    }();
+    return table[initial];
+}
+
+// Traverse the i-th character of key, or the separator after key, from
+// frontier into next. A 0 final matches any final of its initial.
+void traverseFrontier(const JyutpingTrieFrontier &frontier,
+                      std::string_view key, size_t i,
+                      JyutpingTrieFrontier &next) {
+    next.clear();
+    const char current = i < key.size() ? key[i] : jyutpingHanziSep;
+    std::span<const char> chars(&current, 1);
+    if (current == 0) {
+        chars = validFinals(key[i - 1]);
+    }
+    for (const auto &[trie, pos] : frontier) {
+        for (const char c : chars) {
+            auto newPos = pos;
+            if (!JyutpingTrie::isNoPath(trie.traverse(&c, 1, newPos))) {
+                next.emplace_back(trie, newPos);
+            }
+        }
+    }
+}
+
+// Pass all words under frontier, which is after the separator of a key of
+// size, to callback. buffer is reused for the words. Returns false if
+// callback stopped the match.
+template <typename T>
+bool matchFrontierWords(const JyutpingTrieFrontier &frontier, size_t size,
+                        const T &callback, std::string &buffer) {
+    bool stopped = false;
+    for (const auto &node : frontier) {
+        const auto &trie = node.first;
+        trie.foreach(
+            [&trie, &callback, &buffer, &stopped,
+             size](JyutpingTrie::value_type value, size_t len, uint64_t pos) {
+                trie.suffix(buffer, len + size + 1, pos);
+                auto view = std::string_view(buffer);
+                stopped =
+                    !callback(view.substr(0, size), view.substr(size + 1),
+                              value);
+                return !stopped;
+            },
+            node.second);
+        if (stopped) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Match keys in the order of order, which sorts them. The frontiers of each
+// prefix of the previous key are kept, so the next key only traverses from
+// where it differs.
+void matchSortedKeys(const std::vector<JyutpingTrieRef> &tries,
+                     const std::vector<std::string_view> &keys,
+                     std::span<const size_t> order,
+                     const JyutpingBatchMatchCallback &callback) {
+    // levels[i] is the frontier after the first i characters of previous,
+    // only the first depth + 1 are valid.
+    std::vector<JyutpingTrieFrontier> levels(1);
+    for (const auto &trie : tries) {
+        levels[0].emplace_back(trie, 0);
+    }
+    std::string_view previous;
+    size_t previousDepth = 0;
+    JyutpingTrieFrontier words;
+    std::string buffer;
+    for (auto index : order) {
+        const auto key = keys[index];
+        size_t depth = 0;
+        while (depth < previousDepth && depth < key.size() &&
+               key[depth] == previous[depth]) {
+            depth++;
+        }
+        while (depth < key.size() && !levels[depth].empty()) {
+            if (levels.size() == depth + 1) {
+                levels.emplace_back();
+            }
+            traverseFrontier(levels[depth], key, depth, levels[depth + 1]);
+            depth++;
+        }
+        previous = key;
+        previousDepth = depth;
+        if (depth < key.size()) {
+            continue;
+        }
+
+        traverseFrontier(levels[depth], key, depth, words);
+        matchFrontierWords(
+            words, key.size(),
+            [&callback, index](std::string_view encodedJyutping,
+                               std::string_view hanzi, float cost) {
+                return callback(index, encodedJyutping, hanzi, cost);
+            },
+            buffer);
+    }
+}
+
+} // namespace
+
 void JyutpingDictionary::matchWords(const char *data, size_t size,
                                     JyutpingMatchCallback callback) const {
+    FCITX_D();
     if (!JyutpingEncoder::isValidUserJyutping(data, size)) {
         return;
     }
 
-    std::list<std::pair<const JyutpingTrie *, JyutpingTrie::position_type>>
-        nodes;
+    const std::string_view key(data, size);
+    JyutpingTrieFrontier frontier;
+    JyutpingTrieFrontier next;
     for (size_t i = 0; i < dictSize(); i++) {
-        auto &trie = *this->trie(i);
-        nodes.emplace_back(&trie, 0);
+        frontier.emplace_back(d->trie(i), 0);
     }
-    for (size_t i = 0; i <= size && nodes.size(); i++) {
-        char current;
-        if (i < size) {
-            current = data[i];
-        } else {
-            current = jyutpingHanziSep;
-        }
-        decltype(nodes) extraNodes;
-        auto iter = nodes.begin();
-        while (iter != nodes.end()) {
-            if (current != 0) {
-                JyutpingTrie::value_type result;
-                result = iter->first->traverse(&current, 1, iter->second);
-
-                if (JyutpingTrie::isNoPath(result)) {
-                    nodes.erase(iter++);
-                } else {
-                    iter++;
-                }
-            } else {
-                bool changed = false;
-                for (char test = JyutpingEncoder::firstFinal;
-                     test <= JyutpingEncoder::lastFinal; test++) {
-                    decltype(extraNodes)::value_type p = *iter;
-                    auto result = p.first->traverse(&test, 1, p.second);
-                    if (!JyutpingTrie::isNoPath(result)) {
-                        extraNodes.push_back(p);
-                        changed = true;
-                    }
-                }
-                if (changed) {
-                    *iter = extraNodes.back();
-                    extraNodes.pop_back();
-                    iter++;
-                } else {
-                    nodes.erase(iter++);
-                }
-            }
+    for (size_t i = 0; i <= size && !frontier.empty(); i++) {
+        traverseFrontier(frontier, key, i, next);
+        frontier.swap(next);
+    }
+
+    std::string buffer;
+    matchFrontierWords(frontier, size, callback, buffer);
+}
+
+void JyutpingDictionary::matchWordsBatch(
+    const std::vector<std::string_view> &keys,
+    const JyutpingBatchMatchCallback &callback, size_t threads) const {
+    FCITX_D();
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    std::vector<size_t> order;
+    order.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (JyutpingEncoder::isValidUserJyutping(keys[i].data(),
+                                                 keys[i].size())) {
+            order.push_back(i);
         }
-        nodes.splice(nodes.end(), std::move(extraNodes));
     }
+    std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) {
+        return keys[lhs] < keys[rhs];
+    });
 
-    for (auto &node : nodes) {
-        node.first->foreach(
-            [&node, &callback, size](JyutpingTrie::value_type value, size_t len,
-                                     uint64_t pos) {
-                std::string s;
-                node.first->suffix(s, len + size + 1, pos);
+    std::vector<JyutpingTrieRef> tries;
+    for (size_t i = 0; i < dictSize(); i++) {
+        tries.push_back(d->trie(i));
+    }
 
-                auto view = std::string_view(s);
-                return callback(s.substr(0, size), view.substr(size + 1),
-                                value);
-            },
-            node.second);
+    // Not worth a thread for only a few keys.
+    threads = std::min(threads, std::max<size_t>(1, order.size() / 64));
+    if (threads == 1) {
+        matchSortedKeys(tries, keys, order, callback);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        auto chunk = std::span<const size_t>(order).subspan(
+            order.size() * i / threads,
+            order.size() * (i + 1) / threads - order.size() * i / threads);
+        workers.emplace_back([&tries, &keys, &callback, &errors, chunk, i]() {
+            try {
+                matchSortedKeys(tries, keys, chunk, callback);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
     }
 }
+
 JyutpingDictionary::JyutpingDictionary()
     : d_ptr(std::make_unique<JyutpingDictionaryPrivate>(this)) {
     addEmptyDict();
@@ -596,32 +781,60 @@ JyutpingDictionary::~JyutpingDictionary() {}
 
 void JyutpingDictionary::load(size_t idx, const char *filename,
                               JyutpingDictFormat format) {
+    FCITX_D();
     std::ifstream in(filename, std::ios::in | std::ios::binary);
     if (!in) {
         throw std::ios_base::failure("io fail");
     }
+    if (format != JyutpingDictFormat::Text) {
+        // Map the file directly if it's in the packed format.
+        uint32_t magic;
+        uint32_t version;
+        if (unmarshall(in, magic) && unmarshall(in, version) &&
+            magic == jyutpingBinaryFormatMagic &&
+            (version == jyutpingMappedBinaryFormatVersion ||
+             version == jyutpingBlockCompressedBinaryFormatVersion)) {
+            in.close();
+            auto packed = JyutpingPackedTrie::map(
+                filename, sizeof(magic) + sizeof(version),
+                version == jyutpingBlockCompressedBinaryFormatVersion);
+            *mutableTrie(idx) = JyutpingTrie();
+            d->setPackedTrie(idx, std::move(packed));
+            d->journal(idx).clear();
+            emit<JyutpingDictionary::dictionaryChanged>(idx);
+            return;
+        }
+        in.clear();
+        in.seekg(0);
+    }
     load(idx, in, format);
 }
 
 void JyutpingDictionary::load(size_t idx, std::istream &in,
                               JyutpingDictFormat format) {
+    FCITX_D();
     switch (format) {
     case JyutpingDictFormat::Text:
         loadText(idx, in);
         break;
     case JyutpingDictFormat::Binary:
+    case JyutpingDictFormat::MappedBinary:
+    case JyutpingDictFormat::BlockCompressedBinary:
         loadBinary(idx, in);
         break;
     default:
         throw std::invalid_argument("invalid format type");
     }
+    d->journal(idx).clear();
     emit<JyutpingDictionary::dictionaryChanged>(idx);
 }
 
 void JyutpingDictionary::loadText(size_t idx, std::istream &in) {
+    FCITX_D();
     DATrie<float> trie;
 
     std::string buf;
+    std::string key;
     auto isSpaceCheck = boost::is_any_of(" \n\t\r\v\f");
     while (!in.eof()) {
         if (!std::getline(in, buf)) {
@@ -635,16 +848,182 @@ void JyutpingDictionary::loadText(size_t idx, std::istream &in) {
             const std::string &hanzi = tokens[0];
             std::string_view jyutping = tokens[1];
             float prob = std::stof(tokens[2]);
-            auto result = JyutpingEncoder::encodeFullJyutping(jyutping);
-            result.push_back(jyutpingHanziSep);
-            result.insert(result.end(), hanzi.begin(), hanzi.end());
-            trie.set(result.data(), result.size(), prob);
+            encodeWordKey(key, jyutping, hanzi);
+            trie.set(key.data(), key.size(), prob);
         }
     }
     *mutableTrie(idx) = std::move(trie);
+    d->setPackedTrie(idx, nullptr);
+}
+
+namespace {
+
+constexpr std::string_view textSpaces = " \n\t\r\v\f";
+
+using TextEntries = std::vector<std::pair<std::string, float>>;
+
+// Parse a line of text dictionary, it follows the same rule as loadText.
+// Returns false if the line doesn't contain a word.
+bool parseTextLine(std::string_view line, std::string &key, float &value) {
+    const auto begin = line.find_first_not_of(textSpaces);
+    if (begin == std::string_view::npos) {
+        return false;
+    }
+    line = line.substr(begin, line.find_last_not_of(textSpaces) - begin + 1);
+
+    std::array<std::string_view, 3> tokens;
+    size_t count = 0;
+    size_t start = 0;
+    while (true) {
+        if (count == tokens.size()) {
+            return false;
+        }
+        const auto end = line.find_first_of(textSpaces, start);
+        tokens[count++] = line.substr(start, end - start);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    if (count != tokens.size()) {
+        return false;
+    }
+
+    const auto &[hanzi, jyutping, prob] = tokens;
+    const auto *probEnd = prob.data() + prob.size();
+    auto [ptr, ec] = std::from_chars(prob.data(), probEnd, value);
+    // from_chars doesn't take everything that std::stof in loadText does,
+    // e.g. a leading '+' or hex floats. Leave those to std::stof, so both
+    // accept and reject the same text.
+    if (ec != std::errc() || ptr != probEnd) {
+        value = std::stof(std::string(prob));
+    }
+    encodeWordKey(key, jyutping, hanzi);
+    return true;
+}
+
+// Parse all lines in data, returns the number of lines.
+size_t parseTextChunk(std::string_view data, TextEntries &entries) {
+    size_t lines = 0;
+    std::string key;
+    float value;
+    while (!data.empty()) {
+        const auto end = data.find('\n');
+        if (parseTextLine(data.substr(0, end), key, value)) {
+            entries.emplace_back(key, value);
+        }
+        lines++;
+        data.remove_prefix(end == std::string_view::npos ? data.size()
+                                                         : end + 1);
+    }
+    // Same as loadText, a duplicate word overrides the previous one, so
+    // the order of equal keys need to be kept.
+    std::stable_sort(
+        entries.begin(), entries.end(),
+        [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    return lines;
+}
+
+} // namespace
+
+size_t JyutpingDictionary::loadTextParallel(size_t idx, const char *filename,
+                                            size_t threads) {
+    FCITX_D();
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    boost::iostreams::mapped_file_source file;
+    std::string_view data;
+    // Mapping an empty file is an error.
+    if (std::filesystem::file_size(filename) != 0) {
+        try {
+            file.open(filename);
+        } catch (const std::exception &) {
+            throw std::ios_base::failure("io fail");
+        }
+        data = std::string_view(file.data(), file.size());
+    }
+
+    // Split data into chunks at line boundaries.
+    std::vector<std::string_view> chunks;
+    size_t chunkStart = 0;
+    for (size_t i = 1; i <= threads && chunkStart < data.size(); i++) {
+        size_t chunkEnd = data.size();
+        if (i != threads) {
+            chunkEnd = data.find('\n', std::max(chunkStart,
+                                                 data.size() / threads * i));
+            chunkEnd =
+                chunkEnd == std::string_view::npos ? data.size() : chunkEnd + 1;
+        }
+        chunks.push_back(data.substr(chunkStart, chunkEnd - chunkStart));
+        chunkStart = chunkEnd;
+    }
+
+    std::vector<TextEntries> entries(chunks.size());
+    std::vector<size_t> lines(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size());
+    for (size_t i = 0; i < chunks.size(); i++) {
+        workers.emplace_back([&chunks, &entries, &lines, &errors, i]() {
+            try {
+                lines[i] = parseTextChunk(chunks[i], entries[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Merge the sorted chunks into the trie. DATrie is much faster to build
+    // when keys are inserted in order. Equal keys are taken from the earlier
+    // chunk first, so the last duplicate still wins.
+    using Head = std::pair<size_t, size_t>;
+    auto cmp = [&entries](const Head &lhs, const Head &rhs) {
+        const auto &lhsKey = entries[lhs.first][lhs.second].first;
+        const auto &rhsKey = entries[rhs.first][rhs.second].first;
+        if (lhsKey != rhsKey) {
+            return lhsKey > rhsKey;
+        }
+        return lhs.first > rhs.first;
+    };
+    std::priority_queue<Head, std::vector<Head>, decltype(cmp)> heads(cmp);
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (!entries[i].empty()) {
+            heads.emplace(i, 0);
+        }
+    }
+    DATrie<float> trie;
+    while (!heads.empty()) {
+        const auto [chunk, pos] = heads.top();
+        heads.pop();
+        const auto &[key, value] = entries[chunk][pos];
+        trie.set(key.data(), key.size(), value);
+        if (pos + 1 < entries[chunk].size()) {
+            heads.emplace(chunk, pos + 1);
+        }
+    }
+    *mutableTrie(idx) = std::move(trie);
+    d->setPackedTrie(idx, nullptr);
+    emit<JyutpingDictionary::dictionaryChanged>(idx);
+
+    size_t total = 0;
+    for (auto count : lines) {
+        total += count;
+    }
+    return total;
 }
 
 void JyutpingDictionary::loadBinary(size_t idx, std::istream &in) {
+    FCITX_D();
     DATrie<float> trie;
     uint32_t magic;
     uint32_t version;
@@ -672,10 +1051,20 @@ void JyutpingDictionary::loadBinary(size_t idx, std::istream &in) {
         }
         break;
     }
+    case jyutpingMappedBinaryFormatVersion:
+    case jyutpingBlockCompressedBinaryFormatVersion: {
+        auto packed = JyutpingPackedTrie::load(
+            in, sizeof(magic) + sizeof(version),
+            version == jyutpingBlockCompressedBinaryFormatVersion);
+        *mutableTrie(idx) = std::move(trie);
+        d->setPackedTrie(idx, std::move(packed));
+        return;
+    }
     default:
         throw std::invalid_argument("Invalid jyutping version.");
     }
     *mutableTrie(idx) = std::move(trie);
+    d->setPackedTrie(idx, nullptr);
 }
 
 void JyutpingDictionary::save(size_t idx, const char *filename,
@@ -689,10 +1078,52 @@ void JyutpingDictionary::save(size_t idx, const char *filename,
 
 void JyutpingDictionary::save(size_t idx, std::ostream &out,
                               JyutpingDictFormat format) {
+    FCITX_D();
     switch (format) {
     case JyutpingDictFormat::Text:
         saveText(idx, out);
         break;
+    case JyutpingDictFormat::Binary:
+        if (const auto *packed = d->packedTrie(idx)) {
+            auto trie = packed->toDATrie();
+            saveSnapshot(trie, out, format);
+        } else {
+            saveSnapshot(*mutableTrie(idx), out, format);
+        }
+        break;
+    case JyutpingDictFormat::MappedBinary:
+    case JyutpingDictFormat::BlockCompressedBinary: {
+        const auto *packed = d->packedTrie(idx);
+        if (!packed) {
+            saveSnapshot(*mutableTrie(idx), out, format);
+            break;
+        }
+        // Save the packed trie as is, without converting it back and forth.
+        const bool compressed =
+            format == JyutpingDictFormat::BlockCompressedBinary;
+        throw_if_io_fail(marshall(out, jyutpingBinaryFormatMagic));
+        throw_if_io_fail(marshall(
+            out, compressed ? jyutpingBlockCompressedBinaryFormatVersion
+                            : jyutpingMappedBinaryFormatVersion));
+        packed->save(out, jyutpingPackedTrieOffset, compressed);
+        break;
+    }
+    default:
+        throw std::invalid_argument("invalid format type");
+    }
+}
+
+JyutpingTrie JyutpingDictionary::snapshot(size_t idx) const {
+    FCITX_D();
+    if (const auto *packed = d->packedTrie(idx)) {
+        return packed->toDATrie();
+    }
+    return *trie(idx);
+}
+
+void JyutpingDictionary::saveSnapshot(JyutpingTrie &trie, std::ostream &out,
+                                      JyutpingDictFormat format) {
+    switch (format) {
     case JyutpingDictFormat::Binary: {
         throw_if_io_fail(marshall(out, jyutpingBinaryFormatMagic));
         throw_if_io_fail(marshall(out, jyutpingBinaryFormatVersion));
@@ -701,7 +1132,19 @@ void JyutpingDictionary::save(size_t idx, std::ostream &out,
         compressBuf.push(ZSTDCompressor());
         compressBuf.push(out);
         std::ostream compressOut(&compressBuf);
-        mutableTrie(idx)->save(compressOut);
+        trie.save(compressOut);
+        break;
+    }
+    case JyutpingDictFormat::MappedBinary:
+    case JyutpingDictFormat::BlockCompressedBinary: {
+        const bool compressed =
+            format == JyutpingDictFormat::BlockCompressedBinary;
+        throw_if_io_fail(marshall(out, jyutpingBinaryFormatMagic));
+        throw_if_io_fail(marshall(
+            out, compressed ? jyutpingBlockCompressedBinaryFormatVersion
+                            : jyutpingMappedBinaryFormatVersion));
+        JyutpingPackedTrie(trie).save(out, jyutpingPackedTrieOffset,
+                                      compressed);
         break;
     }
     default:
@@ -710,12 +1153,13 @@ void JyutpingDictionary::save(size_t idx, std::ostream &out,
 }
 
 void JyutpingDictionary::saveText(size_t idx, std::ostream &out) {
+    FCITX_D();
     std::string buf;
     std::ios state(nullptr);
     state.copyfmt(out);
-    auto &trie = *this->trie(idx);
-    trie.foreach([this, &trie, &buf, &out](float value, size_t _len,
-                                           JyutpingTrie::position_type pos) {
+    auto trie = d->trie(idx);
+    trie.foreach([&trie, &buf, &out](float value, size_t _len,
+                                     JyutpingTrie::position_type pos) {
         trie.suffix(buf, _len, pos);
         auto sep = buf.find(jyutpingHanziSep);
         if (sep == std::string::npos) {
@@ -733,11 +1177,190 @@ void JyutpingDictionary::saveText(size_t idx, std::ostream &out) {
 
 void JyutpingDictionary::addWord(size_t idx, std::string_view fullJyutping,
                                  std::string_view hanzi, float cost) {
-    auto result = JyutpingEncoder::encodeFullJyutping(fullJyutping);
-    result.push_back(jyutpingHanziSep);
-    result.insert(result.end(), hanzi.begin(), hanzi.end());
-    TrieDictionary::addWord(idx, std::string_view(result.data(), result.size()),
-                            cost);
+    FCITX_D();
+    std::string key;
+    encodeWordKey(key, fullJyutping, hanzi);
+    addWordKey(idx, key, cost);
+    d->journal(idx).push_back({JournalOp::Add, std::move(key), cost});
+}
+
+bool JyutpingDictionary::removeWord(size_t idx, std::string_view key) {
+    FCITX_D();
+    unpack(idx);
+    if (!TrieDictionary::removeWord(idx, key)) {
+        return false;
+    }
+    d->journal(idx).push_back({JournalOp::Remove, std::string(key)});
+    return true;
+}
+
+bool JyutpingDictionary::removeWord(size_t idx, std::string_view fullJyutping,
+                                    std::string_view hanzi) {
+    std::string key;
+    encodeWordKey(key, fullJyutping, hanzi);
+    return removeWord(idx, key);
+}
+
+void JyutpingDictionary::clear(size_t idx) {
+    FCITX_D();
+    d->setPackedTrie(idx, nullptr);
+    TrieDictionary::clear(idx);
+    d->journal(idx).push_back({JournalOp::Clear});
+}
+
+void JyutpingDictionary::addWordKey(size_t idx, std::string_view key,
+                                    float cost) {
+    // Packed trie is read only, convert it back to DATrie for modification.
+    unpack(idx);
+    TrieDictionary::addWord(idx, key, cost);
+}
+
+const JyutpingTrie *JyutpingDictionary::unpack(size_t idx) {
+    FCITX_D();
+    if (const auto *packed = d->packedTrie(idx)) {
+        *mutableTrie(idx) = packed->toDATrie();
+        d->setPackedTrie(idx, nullptr);
+        // Cached trie positions are no longer valid.
+        emit<JyutpingDictionary::dictionaryChanged>(idx);
+    }
+    return trie(idx);
+}
+
+void JyutpingDictionary::saveJournal(size_t idx, std::ostream &out) {
+    FCITX_D();
+    auto &journal = d->journal(idx);
+    if (journal.empty()) {
+        return;
+    }
+    std::ostringstream records;
+    for (const auto &[op, key, cost] : journal) {
+        throw_if_io_fail(marshall(records, static_cast<uint32_t>(op)));
+        throw_if_io_fail(marshall(records, static_cast<uint32_t>(key.size())));
+        throw_if_io_fail(records.write(key.data(), key.size()));
+        throw_if_io_fail(marshall(records, cost));
+    }
+    const auto data = records.str();
+    boost::crc_32_type crc;
+    crc.process_bytes(data.data(), data.size());
+    throw_if_io_fail(marshall(out, jyutpingJournalMagic));
+    throw_if_io_fail(marshall(out, jyutpingJournalVersion));
+    throw_if_io_fail(marshall(out, static_cast<uint32_t>(journal.size())));
+    throw_if_io_fail(marshall(out, static_cast<uint32_t>(data.size())));
+    throw_if_io_fail(marshall(out, static_cast<uint32_t>(crc.checksum())));
+    throw_if_io_fail(out.write(data.data(), data.size()));
+    journal.clear();
+}
+
+namespace {
+
+uint32_t readJournalUint32(std::string_view data, size_t pos) {
+    uint32_t value;
+    std::memcpy(&value, data.data() + pos, sizeof(value));
+    return be32toh(value);
+}
+
+// Parse the chunk at the beginning of data into entries. Returns the size of
+// the chunk, or 0 if data doesn't start with a complete and intact chunk.
+size_t parseJournalChunk(std::string_view data,
+                         std::vector<JournalEntry> &entries) {
+    entries.clear();
+    if (data.size() < jyutpingJournalHeaderSize ||
+        readJournalUint32(data, 0) != jyutpingJournalMagic ||
+        readJournalUint32(data, 4) != jyutpingJournalVersion) {
+        return 0;
+    }
+    const auto count = readJournalUint32(data, 8);
+    const auto length = readJournalUint32(data, 12);
+    if (length > data.size() - jyutpingJournalHeaderSize) {
+        return 0;
+    }
+    auto records = data.substr(jyutpingJournalHeaderSize, length);
+    boost::crc_32_type crc;
+    crc.process_bytes(records.data(), records.size());
+    if (crc.checksum() != readJournalUint32(data, 16)) {
+        return 0;
+    }
+    // Op, key size, key and cost.
+    constexpr size_t fixedSize = 3 * sizeof(uint32_t);
+    for (uint32_t i = 0; i < count; i++) {
+        if (records.size() < fixedSize) {
+            return 0;
+        }
+        const auto op = readJournalUint32(records, 0);
+        const auto size = readJournalUint32(records, sizeof(uint32_t));
+        if (op > static_cast<uint32_t>(JournalOp::Clear) ||
+            size > jyutpingJournalMaxKeySize ||
+            records.size() < size + fixedSize) {
+            return 0;
+        }
+        const auto bits =
+            readJournalUint32(records, 2 * sizeof(uint32_t) + size);
+        float cost;
+        static_assert(sizeof(cost) == sizeof(bits));
+        std::memcpy(&cost, &bits, sizeof(cost));
+        entries.push_back({static_cast<JournalOp>(op),
+                           std::string(records.substr(2 * sizeof(uint32_t),
+                                                      size)),
+                           cost});
+        records.remove_prefix(size + fixedSize);
+    }
+    if (!records.empty()) {
+        return 0;
+    }
+    return jyutpingJournalHeaderSize + length;
+}
+
+} // namespace
+
+size_t JyutpingDictionary::loadJournal(size_t idx, std::istream &in) {
+    FCITX_D();
+    // The journal is a sequence of chunks, each written by saveJournal.
+    // A crash may leave an incomplete chunk, which can be followed by the
+    // chunks appended later. Anything that is not an intact chunk is skipped
+    // until the next one.
+    const std::string data{std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>()};
+    const std::string_view view(data);
+    std::vector<JournalEntry> entries;
+    size_t replayed = 0;
+    size_t pos = 0;
+    while (pos < view.size()) {
+        const auto size = parseJournalChunk(view.substr(pos), entries);
+        if (!size) {
+            pos++;
+            continue;
+        }
+        for (const auto &[op, key, cost] : entries) {
+            switch (op) {
+            case JournalOp::Add:
+                addWordKey(idx, key, cost);
+                break;
+            case JournalOp::Remove:
+                unpack(idx);
+                TrieDictionary::removeWord(idx, key);
+                break;
+            case JournalOp::Clear:
+                d->setPackedTrie(idx, nullptr);
+                TrieDictionary::clear(idx);
+                break;
+            }
+        }
+        replayed += entries.size();
+        pos += size;
+    }
+    return replayed;
+}
+
+size_t JyutpingDictionary::journalSize(size_t idx) const {
+    FCITX_D();
+    return idx < d->journals_.size() ? d->journals_[idx].size() : 0;
+}
+
+void JyutpingDictionary::clearJournal(size_t idx, size_t count) {
+    FCITX_D();
+    auto &journal = d->journal(idx);
+    journal.erase(journal.begin(),
+                  journal.begin() + std::min(count, journal.size()));
 }
 } // namespace jyutping
 } // namespace libime
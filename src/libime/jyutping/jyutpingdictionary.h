@@ -9,21 +9,43 @@
 
 #include "libimejyutping_export.h"
 #include <libime/core/triedictionary.h>
+#include <limits>
+#include <string_view>
+#include <vector>
 
 namespace libime {
 namespace jyutping {
 
-enum class JyutpingDictFormat { Text, Binary };
+// Binary is a zstd compressed trie. MappedBinary is an uncompressed, page
+// aligned trie that is queried in place when loaded from a file, so the memory
+// is shared between processes. BlockCompressedBinary is split into zstd
+// compressed blocks, which are only decompressed when a lookup touches them.
+// All binary formats are equivalent when loading, the actual format is
+// detected from the file.
+enum class JyutpingDictFormat {
+    Text,
+    Binary,
+    MappedBinary,
+    BlockCompressedBinary
+};
 
 class JyutpingDictionaryPrivate;
 
 typedef std::function<bool(std::string_view encodedJyutping,
                            std::string_view hanzi, float cost)>
     JyutpingMatchCallback;
+// Same as JyutpingMatchCallback, with the index of the matched key.
+typedef std::function<bool(size_t index, std::string_view encodedJyutping,
+                           std::string_view hanzi, float cost)>
+    JyutpingBatchMatchCallback;
 class JyutpingDictionary;
 
 using JyutpingTrie = typename TrieDictionary::TrieType;
 
+// A dictionary loaded from a MappedBinary or BlockCompressedBinary file is
+// queried in place, so TrieDictionary::trie() of it is empty until unpack()
+// is called or a word is added. Use snapshot() or unpack() to read all of its
+// words, or matchWords() and matchPrefix() to look words up.
 class LIBIMEJYUTPING_EXPORT JyutpingDictionary : public TrieDictionary {
 public:
     static const size_t SystemDict = 0;
@@ -34,16 +56,66 @@ public:
     // Load dicitonary for a specific dict.
     void load(size_t idx, std::istream &in, JyutpingDictFormat format);
     void load(size_t idx, const char *filename, JyutpingDictFormat format);
-
-    // Match the word by encoded jyutping.
+    // Load a text dictionary file by parsing it with multiple threads, which
+    // is much faster than load for large dictionaries. threads == 0 means
+    // using all available cores. Returns the number of lines in the file.
+    size_t loadTextParallel(size_t idx, const char *filename,
+                            size_t threads = 0);
+
+    // Match the word by encoded jyutping. A 0 final matches any final.
+    // Returning false from callback stops the match.
     void matchWords(const char *data, size_t size,
                     JyutpingMatchCallback callback) const;
+    // Match the words of many encoded jyutping keys, the same as calling
+    // matchWords for every key. Keys are sorted first, so the trie is only
+    // traversed once for a prefix shared by several keys. Sorted keys are
+    // split between threads, threads == 0 means using all available cores.
+    // callback may be called from different threads at the same time if
+    // threads is not 1. Returning false from callback stops matching the
+    // current key only.
+    void matchWordsBatch(const std::vector<std::string_view> &keys,
+                         const JyutpingBatchMatchCallback &callback,
+                         size_t threads = 1) const;
 
     void save(size_t idx, const char *filename, JyutpingDictFormat format);
     void save(size_t idx, std::ostream &out, JyutpingDictFormat format);
 
+    // Convert a dictionary queried in place to DATrie, so it's available from
+    // trie(). Returns trie(idx).
+    const JyutpingTrie *unpack(size_t idx);
+
+    // Copy of a dictionary, which can be saved by saveSnapshot without
+    // touching the dictionary, e.g. from another thread. Text format is not
+    // supported by saveSnapshot.
+    JyutpingTrie snapshot(size_t idx) const;
+    static void saveSnapshot(JyutpingTrie &trie, std::ostream &out,
+                             JyutpingDictFormat format);
+
     void addWord(size_t idx, std::string_view fullJyutping,
                  std::string_view hanzi, float cost = 0.0f);
+    // Same as TrieDictionary::removeWord and TrieDictionary::clear, but also
+    // recorded in the journal. Calling them through TrieDictionary skips the
+    // journal, so the change is undone when the journal is replayed.
+    bool removeWord(size_t idx, std::string_view key);
+    void clear(size_t idx);
+    bool removeWord(size_t idx, std::string_view fullJyutping,
+                    std::string_view hanzi);
+
+    // Changes made by addWord, removeWord and clear are also recorded in a
+    // journal, so a dictionary can be saved by its changes instead of as a
+    // whole. saveJournal appends the recorded changes to out and clears the
+    // journal, loadJournal replays the journals written by saveJournal on
+    // top of the loaded dictionary, and returns the number of changes
+    // replayed. Each chunk written by saveJournal carries its length and
+    // checksum, loadJournal skips anything that is not an intact chunk, e.g.
+    // one cut short by a crash. Loading a dictionary clears its journal.
+    void saveJournal(size_t idx, std::ostream &out);
+    size_t loadJournal(size_t idx, std::istream &in);
+    // Number of changes recorded in the journal.
+    size_t journalSize(size_t idx) const;
+    // Forget the first count recorded changes, usually after a full save.
+    void clearJournal(size_t idx,
+                      size_t count = std::numeric_limits<size_t>::max());
 
     using dictionaryChanged = TrieDictionary::dictionaryChanged;
 
@@ -58,6 +130,7 @@ private:
     void loadText(size_t idx, std::istream &in);
     void loadBinary(size_t idx, std::istream &in);
     void saveText(size_t idx, std::ostream &out);
+    void addWordKey(size_t idx, std::string_view key, float cost);
 
     std::unique_ptr<JyutpingDictionaryPrivate> d_ptr;
     FCITX_DECLARE_PRIVATE(JyutpingDictionary);
@@ -0,0 +1,236 @@
+/*
+ * SPDX-FileCopyrightText: 2026~2026 CSSlayer <wengxt@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+#ifndef _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGDICTIONARY_P_H_
+#define _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGDICTIONARY_P_H_
+
+#include "jyutpingdata.h"
+#include "jyutpingmatchstate_p.h"
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <libime/core/segmentgraph.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+// Matching primitives of JyutpingDictionary, they are kept in a header so
+// they can be benchmarked individually.
+
+namespace libime {
+namespace jyutping {
+
+inline const float fuzzyCost = std::log10(0.5f);
+inline constexpr char jyutpingHanziSep = '\x01';
+
+struct JyutpingSegmentGraphPathHasher {
+    JyutpingSegmentGraphPathHasher(const SegmentGraph &graph) : graph_(graph) {}
+
+    // Generate a "|" separated raw jyutping string from given path, skip all
+    // separator.
+    std::string pathToJyutpings(const SegmentGraphPath &path) const {
+        std::string result;
+        result.reserve(path.size() + path.back()->index() -
+                       path.front()->index() + 1);
+        const auto &data = graph_.data();
+        auto iter = path.begin();
+        while (iter + 1 < path.end()) {
+            auto begin = (*iter)->index();
+            auto end = (*std::next(iter))->index();
+            iter++;
+            if (data[begin] == '\'') {
+                continue;
+            }
+            while (begin < end) {
+                result.push_back(data[begin]);
+                begin++;
+            }
+            result.push_back('|');
+        }
+        return result;
+    }
+
+    // Generate hash for path but avoid allocate the string.
+    size_t operator()(const SegmentGraphPath &path) const {
+        if (path.size() <= 1) {
+            return 0;
+        }
+        boost::hash<char> hasher;
+
+        size_t seed = 0;
+        const auto &data = graph_.data();
+        auto iter = path.begin();
+        while (iter + 1 < path.end()) {
+            auto begin = (*iter)->index();
+            auto end = (*std::next(iter))->index();
+            iter++;
+            if (data[begin] == '\'') {
+                continue;
+            }
+            while (begin < end) {
+                boost::hash_combine(seed, hasher(data[begin]));
+                begin++;
+            }
+            boost::hash_combine(seed, hasher('|'));
+        }
+        return seed;
+    }
+
+    // Check equality of jyutping string and the path. The string s should be
+    // equal to pathToJyutpings(path), but this function just try to avoid
+    // allocate a string for comparisin.
+    bool operator()(const SegmentGraphPath &path, const std::string &s) const {
+        if (path.size() <= 1) {
+            return false;
+        }
+        auto is = s.begin();
+        const auto &data = graph_.data();
+        auto iter = path.begin();
+        while (iter + 1 < path.end() && is != s.end()) {
+            auto begin = (*iter)->index();
+            auto end = (*std::next(iter))->index();
+            iter++;
+            if (data[begin] == '\'') {
+                continue;
+            }
+            while (begin < end && is != s.end()) {
+                if (*is != data[begin]) {
+                    return false;
+                }
+                is++;
+                begin++;
+            }
+            if (begin != end) {
+                return false;
+            }
+
+            if (is == s.end() || *is != '|') {
+                return false;
+            }
+            is++;
+        }
+        return iter + 1 == path.end() && is == s.end();
+    }
+
+private:
+    const SegmentGraph &graph_;
+};
+
+// Traverse one syllable from all trie positions of path, and store the new
+// positions in positions. positions is cleared first, so the same buffer can
+// be reused for every step.
+inline void traverseAlongPathOneStepBySyllables(
+    const MatchedJyutpingPath &path,
+    std::span<const JyutpingSyllableExpansion> syls,
+    JyutpingTriePositions &positions) {
+    positions.clear();
+    for (const auto &pr : path.triePositions()) {
+        uint64_t _pos;
+        size_t fuzzies;
+        std::tie(_pos, fuzzies) = pr;
+        for (const auto &syl : syls) {
+            // make a copy
+            auto pos = _pos;
+            auto initial = static_cast<char>(syl.initial);
+            auto result = path.trie().traverse(&initial, 1, pos);
+            if (JyutpingTrie::isNoPath(result)) {
+                continue;
+            }
+            for (const auto &final : syl.finals) {
+                auto finalPos = pos;
+                auto finalChar = static_cast<char>(final.final);
+                auto result = path.trie().traverse(&finalChar, 1, finalPos);
+                if (!JyutpingTrie::isNoPath(result)) {
+                    positions.emplace_back(finalPos, fuzzies + final.fuzzies);
+                }
+            }
+        }
+    }
+}
+
+// Enumerate all words under the trie positions of path. All words under the
+// same position share the same encoded jyutping, so it is only built once
+// per position, and only the hanzi is rebuilt for each word. The views
+// passed to callback are only valid during the call.
+//
+// If limit is not 0, only the limit best words of the path are passed to
+// callback, in descending order of cost.
+template <typename T>
+void matchWordsOnTrie(const MatchedJyutpingPath &path, const T &callback,
+                      size_t limit = 0) {
+    const char sep = jyutpingHanziSep;
+    const size_t jyutpingSize = path.size() * 2;
+    std::string encodedJyutping;
+    std::string hanzi;
+    // Best words of all positions when limit is set: cost, index of encoded
+    // jyutping in jyutpings, hanzi.
+    std::vector<std::string> jyutpings;
+    std::vector<std::tuple<float, size_t, std::string>> best;
+    for (auto &pr : path.triePositions()) {
+        uint64_t pos;
+        size_t fuzzies;
+        std::tie(pos, fuzzies) = pr;
+        float extraCost = fuzzies * fuzzyCost;
+        auto result = path.trie().traverse(&sep, 1, pos);
+        if (JyutpingTrie::isNoPath(result)) {
+            continue;
+        }
+        // Drop the separator at the end.
+        path.trie().suffix(encodedJyutping, jyutpingSize + 1, pos);
+        encodedJyutping.pop_back();
+
+        if (limit) {
+            path.trie().foreachBest(
+                [&path, &best, &hanzi, &jyutpings,
+                 extraCost](JyutpingTrie::value_type value, size_t len,
+                            uint64_t pos) {
+                    path.trie().suffix(hanzi, len, pos);
+                    best.emplace_back(value + extraCost, jyutpings.size(),
+                                      hanzi);
+                },
+                limit, pos);
+            jyutpings.push_back(encodedJyutping);
+            continue;
+        }
+
+        path.trie().foreach(
+            [&path, &callback, &encodedJyutping, &hanzi,
+             extraCost](JyutpingTrie::value_type value, size_t len,
+                        uint64_t pos) {
+                path.trie().suffix(hanzi, len, pos);
+                callback(std::string_view(encodedJyutping),
+                         std::string_view(hanzi), value + extraCost);
+                return true;
+            },
+            pos);
+    }
+
+    if (!limit) {
+        return;
+    }
+    // Every position returns its best words in order, so they only need to
+    // be merged when there is more than one position.
+    if (jyutpings.size() > 1) {
+        std::stable_sort(best.begin(), best.end(),
+                         [](const auto &lhs, const auto &rhs) {
+                             return std::get<0>(lhs) > std::get<0>(rhs);
+                         });
+    }
+    best.resize(std::min(best.size(), limit));
+    for (const auto &[cost, index, word] : best) {
+        callback(std::string_view(jyutpings[index]), std::string_view(word),
+                 cost);
+    }
+}
+
+} // namespace jyutping
+} // namespace libime
+
+#endif // _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGDICTIONARY_P_H_
@@ -6,67 +6,59 @@
  */
 #include "jyutpingencoder.h"
 #include "jyutpingdata.h"
-#include <boost/algorithm/string.hpp>
-#include <boost/bimap.hpp>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
 #include <queue>
+#include <string_view>
 
 namespace libime {
 namespace jyutping {
 
 static const std::string emptyString;
 
-template <typename L, typename R>
-boost::bimap<L, R>
-makeBimap(std::initializer_list<typename boost::bimap<L, R>::value_type> list) {
-    return boost::bimap<L, R>(list.begin(), list.end());
+// Indexed by JyutpingInitial - firstInitial.
+constexpr std::string_view initialNames[] = {
+    "b",  "p",  "m",  "f",  "d",  "t",  "n",  "l",  "g",  "k",
+    "ng", "h",  "gw", "kw", "w",  "z",  "c",  "s",  "j",  "",
+};
+
+static_assert(std::size(initialNames) ==
+              JyutpingEncoder::lastInitial - JyutpingEncoder::firstInitial + 1);
+
+// Indexed by JyutpingFinal - firstFinal.
+constexpr std::string_view finalNames[] = {
+    "aa",   "aai",  "aau",  "aam",  "aan",  "aang", "aap",  "aat",  "aak",
+    "ai",   "au",   "am",   "an",   "ang",  "ap",   "at",   "ak",   "e",
+    "ei",   "et",   "eu",   "em",   "en",   "eng",  "ep",   "ek",   "i",
+    "iu",   "im",   "in",   "ing",  "ip",   "it",   "ik",   "o",    "oi",
+    "ou",   "on",   "ong",  "ot",   "ok",   "oe",   "oeng", "oek",  "om",
+    "eoi",  "eon",  "eot",  "u",    "ui",   "un",   "ung",  "ut",   "uk",
+    "yu",   "yun",  "yut",  "m",    "ng",   "",
+};
+
+static_assert(std::size(finalNames) ==
+              JyutpingEncoder::lastFinal - JyutpingEncoder::firstFinal + 1);
+
+static JyutpingInitial findInitial(std::string_view str) {
+    auto iter =
+        std::find(std::begin(initialNames), std::end(initialNames), str);
+    if (iter == std::end(initialNames)) {
+        return JyutpingInitial::Invalid;
+    }
+    return static_cast<JyutpingInitial>(JyutpingEncoder::firstInitial +
+                                        (iter - std::begin(initialNames)));
 }
 
-static const auto initialMap = makeBimap<JyutpingInitial, std::string>({
-    {JyutpingInitial::B, "b"},   {JyutpingInitial::P, "p"},
-    {JyutpingInitial::M, "m"},   {JyutpingInitial::F, "f"},
-    {JyutpingInitial::D, "d"},   {JyutpingInitial::T, "t"},
-    {JyutpingInitial::N, "n"},   {JyutpingInitial::L, "l"},
-    {JyutpingInitial::G, "g"},   {JyutpingInitial::K, "k"},
-    {JyutpingInitial::NG, "ng"}, {JyutpingInitial::H, "h"},
-    {JyutpingInitial::GW, "gw"}, {JyutpingInitial::KW, "kw"},
-    {JyutpingInitial::W, "gw"},  {JyutpingInitial::W, "w"},
-    {JyutpingInitial::Z, "z"},   {JyutpingInitial::C, "c"},
-    {JyutpingInitial::S, "s"},   {JyutpingInitial::J, "j"},
-    {JyutpingInitial::Zero, ""},
-});
-
-static const auto finalMap = makeBimap<JyutpingFinal, std::string>({
-    {JyutpingFinal::AA, "aa"},   {JyutpingFinal::AAI, "aai"},
-    {JyutpingFinal::AAU, "aau"}, {JyutpingFinal::AAM, "aam"},
-    {JyutpingFinal::AAN, "aan"}, {JyutpingFinal::AANG, "aang"},
-    {JyutpingFinal::AAP, "aap"}, {JyutpingFinal::AAT, "aat"},
-    {JyutpingFinal::AAK, "aak"}, {JyutpingFinal::AI, "ai"},
-    {JyutpingFinal::AU, "au"},   {JyutpingFinal::AM, "am"},
-    {JyutpingFinal::AN, "an"},   {JyutpingFinal::ANG, "ang"},
-    {JyutpingFinal::AP, "ap"},   {JyutpingFinal::AT, "at"},
-    {JyutpingFinal::AK, "ak"},   {JyutpingFinal::E, "e"},
-    {JyutpingFinal::EI, "ei"},   {JyutpingFinal::ET, "et"},
-    {JyutpingFinal::EU, "eu"},   {JyutpingFinal::EM, "em"},
-    {JyutpingFinal::EN, "en"},   {JyutpingFinal::ENG, "eng"},
-    {JyutpingFinal::EP, "ep"},   {JyutpingFinal::EK, "ek"},
-    {JyutpingFinal::I, "i"},     {JyutpingFinal::IU, "iu"},
-    {JyutpingFinal::IM, "im"},   {JyutpingFinal::IN, "in"},
-    {JyutpingFinal::ING, "ing"}, {JyutpingFinal::IP, "ip"},
-    {JyutpingFinal::IT, "it"},   {JyutpingFinal::IK, "ik"},
-    {JyutpingFinal::O, "o"},     {JyutpingFinal::OI, "oi"},
-    {JyutpingFinal::OU, "ou"},   {JyutpingFinal::OM, "om"},
-    {JyutpingFinal::ON, "on"},   {JyutpingFinal::ONG, "ong"},
-    {JyutpingFinal::OT, "ot"},   {JyutpingFinal::OK, "ok"},
-    {JyutpingFinal::OE, "oe"},   {JyutpingFinal::OENG, "oeng"},
-    {JyutpingFinal::OEK, "oek"}, {JyutpingFinal::EOI, "eoi"},
-    {JyutpingFinal::EON, "eon"}, {JyutpingFinal::EOT, "eot"},
-    {JyutpingFinal::U, "u"},     {JyutpingFinal::UI, "ui"},
-    {JyutpingFinal::UN, "un"},   {JyutpingFinal::UNG, "ung"},
-    {JyutpingFinal::UT, "ut"},   {JyutpingFinal::UK, "uk"},
-    {JyutpingFinal::YU, "yu"},   {JyutpingFinal::YUN, "yun"},
-    {JyutpingFinal::YUT, "yut"}, {JyutpingFinal::M, "m"},
-    {JyutpingFinal::NG, "ng"},   {JyutpingFinal::Zero, ""},
-});
+static JyutpingFinal findFinal(std::string_view str) {
+    auto iter = std::find(std::begin(finalNames), std::end(finalNames), str);
+    if (iter == std::end(finalNames)) {
+        return JyutpingFinal::Invalid;
+    }
+    return static_cast<JyutpingFinal>(JyutpingEncoder::firstFinal +
+                                      (iter - std::begin(finalNames)));
+}
 
 static const int maxJyutpingLength = 6;
 
@@ -76,18 +68,14 @@ std::pair<std::string_view, bool> longestMatch(Iter iter, Iter end) {
         end = iter + maxJyutpingLength;
     }
     auto range = std::string_view(&*iter, std::distance(iter, end));
-    auto &map = getJyutpingMap();
     for (; range.size(); range.remove_suffix(1)) {
-        auto iterPair = map.equal_range(range);
-        if (iterPair.first != iterPair.second) {
+        if (findJyutpingSyllable(range)) {
             // do not consider m/ng as complete jyutping
             return std::make_pair(range, (range != "m" && range != "ng"));
         }
-        if (range.size() <= 2) {
-            auto iter = initialMap.right.find(std::string{range});
-            if (iter != initialMap.right.end()) {
-                return std::make_pair(range, false);
-            }
+        if (range.size() <= 2 &&
+            findInitial(range) != JyutpingInitial::Invalid) {
+            return std::make_pair(range, false);
         }
     }
 
@@ -103,11 +91,113 @@ std::string JyutpingSyllable::toString() const {
            JyutpingEncoder::finalToString(final_);
 }
 
-SegmentGraph JyutpingEncoder::parseUserJyutping(std::string userJyutping,
-                                                bool inner) {
+namespace {
+
+struct JyutpingParseEdge {
+    size_t from;
+    size_t to;
+    // Whether to need to continue parsing from to.
+    bool push;
+};
+
+// Edges added when parsing from one position.
+struct JyutpingParseStep {
+    void clear() {
+        edges.clear();
+        needed = std::numeric_limits<size_t>::max();
+    }
+
+    std::vector<JyutpingParseEdge> edges;
+    // Length of input prefix that this step depends on, it's larger than the
+    // input size if it depends on the end of input.
+    size_t needed = std::numeric_limits<size_t>::max();
+};
+
+void parseUserJyutpingStep(std::string_view jyutping, size_t top, bool inner,
+                           JyutpingParseStep &step) {
+    step.clear();
+    auto addNext = [&step](size_t from, size_t to, bool push) {
+        step.edges.push_back({from, to, push});
+    };
+    if (jyutping[top] == '\'') {
+        size_t next = top;
+        while (next < jyutping.size() && jyutping[next] == '\'') {
+            next++;
+        }
+        addNext(top, next, next < jyutping.size());
+        step.needed = next + 1;
+        return;
+    }
+    // Longest match on the next two syllables may look at this many
+    // characters.
+    step.needed = top + maxJyutpingLength * 2;
+    if (step.needed > jyutping.size()) {
+        step.needed = jyutping.size() + 1;
+    }
+
+    auto iter = std::next(jyutping.begin(), top);
+    auto end = jyutping.end();
+    std::string_view str;
+    bool isCompleteJyutping;
+    std::tie(str, isCompleteJyutping) = longestMatch(iter, end);
+
+    // it's not complete a jyutping, no need to try
+    if (!isCompleteJyutping) {
+        addNext(top, top + str.size(), true);
+        return;
+    }
+    // check fuzzy seg
+    // jyutping may end with aegikmnoptu
+    // and may start with abcdefghjklmnopstuwz.
+    // the intersection is aegkmnoptu.
+    // also, make sure current jyutping does not end with a separator.
+    std::array<size_t, 2> nextSize;
+    size_t nNextSize = 0;
+    if (str.size() > 1 && top + str.size() < jyutping.size() &&
+        jyutping[top + str.size()] != '\'' &&
+        (str.back() == 'a' || str.back() == 'e' || str.back() == 'g' ||
+         str.back() == 'k' || str.back() == 'm' || str.back() == 'n' ||
+         str.back() == 'o' || str.back() == 'p' || str.back() == 't' ||
+         str.back() == 'u') &&
+        findJyutpingSyllable(str.substr(0, str.size() - 1))) {
+        // str[0:-1] is also a full jyutping, check next jyutping
+        auto nextMatch = longestMatch(iter + str.size(), end);
+        auto nextMatchAlt = longestMatch(iter + str.size() - 1, end);
+        auto matchSize = str.size() + nextMatch.first.size();
+        auto matchSizeAlt = str.size() - 1 + nextMatchAlt.first.size();
+        if (std::make_pair(matchSize, nextMatch.second) >=
+            std::make_pair(matchSizeAlt, nextMatchAlt.second)) {
+            addNext(top, top + str.size(), true);
+            nextSize[nNextSize++] = str.size();
+        }
+        if (std::make_pair(matchSize, nextMatch.second) <=
+            std::make_pair(matchSizeAlt, nextMatchAlt.second)) {
+            addNext(top, top + str.size() - 1, true);
+            nextSize[nNextSize++] = str.size() - 1;
+        }
+    } else {
+        addNext(top, top + str.size(), true);
+        nextSize[nNextSize++] = str.size();
+    }
+
+    for (size_t i = 0; i < nNextSize; i++) {
+        if (nextSize[i] >= 4 && inner) {
+            if (const auto *segment =
+                    findInnerSegment(str.substr(0, nextSize[i]))) {
+                addNext(top, top + segment->first.size(), false);
+                addNext(top + segment->first.size(), top + nextSize[i], false);
+            }
+        }
+    }
+}
+
+// Build the segment graph by visiting positions in order, getStep returns
+// the edges added when parsing from a position.
+template <typename GetStep>
+SegmentGraph parseUserJyutpingWithSteps(std::string userJyutping,
+                                        const GetStep &getStep) {
     SegmentGraph result(std::move(userJyutping));
     const auto &jyutping = result.data();
-    auto end = jyutping.end();
     std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> q;
     q.push(0);
     while (q.size()) {
@@ -119,80 +209,85 @@ SegmentGraph JyutpingEncoder::parseUserJyutping(std::string userJyutping,
         if (top >= jyutping.size()) {
             continue;
         }
-        auto iter = std::next(jyutping.begin(), top);
-        if (*iter == '\'') {
-            while (*iter == '\'' && iter != jyutping.end()) {
-                iter++;
-            }
-            auto next = std::distance(jyutping.begin(), iter);
-            result.addNext(top, next);
-            if (static_cast<size_t>(next) < jyutping.size()) {
-                q.push(next);
+        const JyutpingParseStep &step = getStep(jyutping, top);
+        for (const auto &edge : step.edges) {
+            result.addNext(edge.from, edge.to);
+            if (edge.push) {
+                q.push(edge.to);
             }
-            continue;
         }
-        std::string_view str;
-        bool isCompleteJyutping;
-        std::tie(str, isCompleteJyutping) = longestMatch(iter, end);
-
-        // it's not complete a jyutping, no need to try
-        if (!isCompleteJyutping) {
-            result.addNext(top, top + str.size());
-            q.push(top + str.size());
-        } else {
-            // check fuzzy seg
-            // jyutping may end with aegikmnoptu
-            // and may start with abcdefghjklmnopstuwz.
-            // the intersection is aegkmnoptu.
-            // also, make sure current jyutping does not end with a separator.
-            auto &map = getJyutpingMap();
-            std::array<size_t, 2> nextSize;
-            size_t nNextSize = 0;
-            if (str.size() > 1 && top + str.size() < jyutping.size() &&
-                jyutping[top + str.size()] != '\'' &&
-                (str.back() == 'a' || str.back() == 'e' || str.back() == 'g' ||
-                 str.back() == 'k' || str.back() == 'm' || str.back() == 'n' ||
-                 str.back() == 'o' || str.back() == 'p' || str.back() == 't' ||
-                 str.back() == 'u') &&
-                map.find(str.substr(0, str.size() - 1)) != map.end()) {
-                // str[0:-1] is also a full jyutping, check next jyutping
-                auto nextMatch = longestMatch(iter + str.size(), end);
-                auto nextMatchAlt = longestMatch(iter + str.size() - 1, end);
-                auto matchSize = str.size() + nextMatch.first.size();
-                auto matchSizeAlt = str.size() - 1 + nextMatchAlt.first.size();
-                if (std::make_pair(matchSize, nextMatch.second) >=
-                    std::make_pair(matchSizeAlt, nextMatchAlt.second)) {
-                    result.addNext(top, top + str.size());
-                    q.push(top + str.size());
-                    nextSize[nNextSize++] = str.size();
-                }
-                if (std::make_pair(matchSize, nextMatch.second) <=
-                    std::make_pair(matchSizeAlt, nextMatchAlt.second)) {
-                    result.addNext(top, top + str.size() - 1);
-                    q.push(top + str.size() - 1);
-                    nextSize[nNextSize++] = str.size() - 1;
-                }
+    }
+    return result;
+}
+
+} // namespace
+
+class JyutpingIncrementalParserPrivate {
+public:
+    std::string data_;
+    bool inner_ = false;
+    // Parse step of each position in data_.
+    std::vector<JyutpingParseStep> steps_;
+    std::vector<JyutpingParseStep> newSteps_;
+};
+
+SegmentGraph JyutpingEncoder::parseUserJyutping(std::string userJyutping,
+                                                bool inner) {
+    JyutpingParseStep step;
+    return parseUserJyutpingWithSteps(
+        std::move(userJyutping),
+        [inner, &step](std::string_view jyutping,
+                       size_t top) -> const JyutpingParseStep & {
+            parseUserJyutpingStep(jyutping, top, inner, step);
+            return step;
+        });
+}
+
+JyutpingIncrementalParser::JyutpingIncrementalParser()
+    : d_ptr(std::make_unique<JyutpingIncrementalParserPrivate>()) {}
+
+JyutpingIncrementalParser::~JyutpingIncrementalParser() = default;
+
+SegmentGraph JyutpingIncrementalParser::parse(std::string userJyutping,
+                                              bool inner) {
+    FCITX_D();
+    size_t common = 0;
+    if (inner == d->inner_) {
+        common = std::mismatch(d->data_.begin(), d->data_.end(),
+                               userJyutping.begin(), userJyutping.end())
+                     .first -
+                 d->data_.begin();
+    }
+
+    auto &newSteps = d->newSteps_;
+    newSteps.resize(userJyutping.size());
+    for (auto &step : newSteps) {
+        step.clear();
+    }
+    auto graph = parseUserJyutpingWithSteps(
+        std::move(userJyutping),
+        [d, inner, common, &newSteps](std::string_view jyutping,
+                                      size_t top) -> const JyutpingParseStep & {
+            auto &step = newSteps[top];
+            // Reuse the previous step if the input it depends on is
+            // unchanged.
+            if (top < d->steps_.size() && d->steps_[top].needed <= common) {
+                std::swap(step, d->steps_[top]);
             } else {
-                result.addNext(top, top + str.size());
-                q.push(top + str.size());
-                nextSize[nNextSize++] = str.size();
+                parseUserJyutpingStep(jyutping, top, inner, step);
             }
+            return step;
+        });
+    std::swap(d->steps_, newSteps);
+    d->data_ = graph.data();
+    d->inner_ = inner;
+    return graph;
+}
 
-            for (size_t i = 0; i < nNextSize; i++) {
-                if (nextSize[i] >= 4 && inner) {
-                    auto &innerSegments = getInnerSegment();
-                    auto iter = innerSegments.find(
-                        std::string{str.substr(0, nextSize[i])});
-                    if (iter != innerSegments.end()) {
-                        result.addNext(top, top + iter->second.first.size());
-                        result.addNext(top + iter->second.first.size(),
-                                       top + nextSize[i]);
-                    }
-                }
-            }
-        }
-    }
-    return result;
+void JyutpingIncrementalParser::reset() {
+    FCITX_D();
+    d->data_.clear();
+    d->steps_.clear();
 }
 
 std::vector<char> JyutpingEncoder::encodeOneUserJyutping(std::string jyutping) {
@@ -252,8 +347,7 @@ const std::string &JyutpingEncoder::initialToString(JyutpingInitial initial) {
         std::vector<std::string> s;
         s.resize(lastInitial - firstInitial + 1);
         for (char c = firstInitial; c <= lastInitial; c++) {
-            auto iter = initialMap.left.find(static_cast<JyutpingInitial>(c));
-            s[c - firstInitial] = iter->second;
+            s[c - firstInitial] = initialNames[c - firstInitial];
         }
         return s;
     }();
@@ -265,11 +359,7 @@ const std::string &JyutpingEncoder::initialToString(JyutpingInitial initial) {
 }
 
 JyutpingInitial JyutpingEncoder::stringToInitial(const std::string &str) {
-    auto iter = initialMap.right.find(str);
-    if (iter != initialMap.right.end()) {
-        return iter->second;
-    }
-    return JyutpingInitial::Invalid;
+    return findInitial(str);
 }
 
 const std::string &JyutpingEncoder::finalToString(JyutpingFinal final) {
@@ -277,8 +367,7 @@ const std::string &JyutpingEncoder::finalToString(JyutpingFinal final) {
         std::vector<std::string> s;
         s.resize(lastFinal - firstFinal + 1);
         for (char c = firstFinal; c <= lastFinal; c++) {
-            auto iter = finalMap.left.find(static_cast<JyutpingFinal>(c));
-            s[c - firstFinal] = iter->second;
+            s[c - firstFinal] = finalNames[c - firstFinal];
         }
         return s;
     }();
@@ -290,25 +379,7 @@ const std::string &JyutpingEncoder::finalToString(JyutpingFinal final) {
 }
 
 JyutpingFinal JyutpingEncoder::stringToFinal(const std::string &str) {
-    auto iter = finalMap.right.find(str);
-    if (iter != finalMap.right.end()) {
-        return iter->second;
-    }
-    return JyutpingFinal::Invalid;
-}
-
-bool JyutpingEncoder::isValidInitialFinal(JyutpingInitial initial,
-                                          JyutpingFinal final) {
-    if (initial != JyutpingInitial::Invalid &&
-        final != JyutpingFinal::Invalid) {
-        int16_t encode =
-            ((static_cast<int16_t>(initial) - JyutpingEncoder::firstInitial) *
-             (JyutpingEncoder::lastFinal - JyutpingEncoder::firstFinal + 1)) +
-            (static_cast<int16_t>(final) - JyutpingEncoder::firstFinal);
-        const auto &a = getEncodedInitialFinal();
-        return encode < static_cast<int>(a.size()) && a[encode];
-    }
-    return false;
+    return findFinal(str);
 }
 
 static void getFuzzy(
@@ -352,20 +423,17 @@ JyutpingEncoder::stringToSyllables(std::string_view jyutping) {
     std::vector<
         std::pair<JyutpingInitial, std::vector<std::pair<JyutpingFinal, bool>>>>
         result;
-    auto &map = getJyutpingMap();
     // we only want {M,N,R}/Invalid instead of {M,N,R}/Zero, so we could get
     // match for everything.
     if (jyutping != "m" && jyutping != "ng") {
-        auto iterPair = map.equal_range(jyutping);
-        for (auto &item :
-             boost::make_iterator_range(iterPair.first, iterPair.second)) {
-            getFuzzy(result, {item.initial(), item.final()});
+        if (const auto *entry = findJyutpingSyllable(jyutping)) {
+            getFuzzy(result, {entry->initial, entry->final});
         }
     }
 
-    auto iter = initialMap.right.find(std::string{jyutping});
-    if (initialMap.right.end() != iter) {
-        getFuzzy(result, {iter->second, JyutpingFinal::Invalid});
+    auto initial = findInitial(jyutping);
+    if (initial != JyutpingInitial::Invalid) {
+        getFuzzy(result, {initial, JyutpingFinal::Invalid});
     }
 
     if (result.size() == 0) {
@@ -381,23 +449,33 @@ JyutpingEncoder::stringToSyllables(std::string_view jyutping) {
 
 std::vector<char>
 JyutpingEncoder::encodeFullJyutping(std::string_view jyutping) {
-    std::vector<std::string> jyutpings;
-    boost::split(jyutpings, jyutping, boost::is_any_of("'"));
-    std::vector<char> result;
-    result.resize(jyutpings.size() * 2);
-    int idx = 0;
-    for (const auto &singleJyutping : jyutpings) {
-        auto &map = getJyutpingMap();
-        auto iter = map.find(singleJyutping);
-        if (iter == map.end()) {
+    std::vector<char> result(encodedFullJyutpingSize(jyutping));
+    result.resize(encodeFullJyutping(jyutping, result.data(), result.size()));
+    return result;
+}
+
+size_t JyutpingEncoder::encodeFullJyutping(std::string_view jyutping,
+                                           char *buffer, size_t size) {
+    size_t idx = 0;
+    std::string_view remain = jyutping;
+    while (true) {
+        const auto sep = remain.find('\'');
+        const auto *entry = findJyutpingSyllable(remain.substr(0, sep));
+        if (!entry) {
             throw std::invalid_argument("invalid full jyutping: " +
                                         std::string{jyutping});
         }
-        result[idx++] = static_cast<char>(iter->initial());
-        result[idx++] = static_cast<char>(iter->final());
+        if (idx + 2 > size) {
+            throw std::invalid_argument("buffer is too small");
+        }
+        buffer[idx++] = static_cast<char>(entry->initial);
+        buffer[idx++] = static_cast<char>(entry->final);
+        if (sep == std::string_view::npos) {
+            break;
+        }
+        remain.remove_prefix(sep + 1);
     }
-
-    return result;
+    return idx;
 }
 
 } // namespace jyutping
@@ -8,7 +8,10 @@
 #define _LIBIME_JYUTPING_JYUTPINGENCODER_H_
 
 #include "libimejyutping_export.h"
+#include <algorithm>
+#include <fcitx-utils/macros.h>
 #include <libime/core/segmentgraph.h>
+#include <memory>
 
 namespace libime {
 namespace jyutping {
@@ -149,6 +152,14 @@ public:
     static bool isValidUserJyutping(const char *data, size_t size);
 
     static std::vector<char> encodeFullJyutping(std::string_view jyutping);
+    // Encode full jyutping into buffer without any allocation. buffer needs
+    // to hold at least encodedFullJyutpingSize(jyutping) bytes. Returns the
+    // size of encoded data.
+    static size_t encodeFullJyutping(std::string_view jyutping, char *buffer,
+                                     size_t size);
+    static size_t encodedFullJyutpingSize(std::string_view jyutping) {
+        return (std::count(jyutping.begin(), jyutping.end(), '\'') + 1) * 2;
+    }
 
     static std::string decodeFullJyutping(const char *data, size_t size);
     static std::string decodeFullJyutping(std::string_view data) {
@@ -179,6 +190,25 @@ public:
     static const char lastFinal = static_cast<char>(JyutpingFinal::Zero);
 };
 
+class JyutpingIncrementalParserPrivate;
+
+// Parse user jyutping incrementally. It keeps the parse result of every
+// position from the last parse, so after an edit, only the positions that
+// may see the edited part of the input are parsed again. The result is
+// always the same as JyutpingEncoder::parseUserJyutping.
+class LIBIMEJYUTPING_EXPORT JyutpingIncrementalParser {
+public:
+    JyutpingIncrementalParser();
+    ~JyutpingIncrementalParser();
+
+    SegmentGraph parse(std::string userJyutping, bool inner = true);
+    void reset();
+
+private:
+    std::unique_ptr<JyutpingIncrementalParserPrivate> d_ptr;
+    FCITX_DECLARE_PRIVATE(JyutpingIncrementalParser);
+};
+
 } // namespace jyutping
 } // namespace libime
 
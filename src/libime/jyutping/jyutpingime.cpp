@@ -7,32 +7,13 @@
 
 #include "jyutpingime.h"
 #include "jyutpingdecoder.h"
+#include "jyutpingime_p.h"
 #include "libime/core/userlanguagemodel.h"
+#include <algorithm>
 
 namespace libime {
 namespace jyutping {
 
-class JyutpingIMEPrivate : fcitx::QPtrHolder<JyutpingIME> {
-public:
-    JyutpingIMEPrivate(JyutpingIME *q, std::unique_ptr<JyutpingDictionary> dict,
-                       std::unique_ptr<UserLanguageModel> model)
-        : fcitx::QPtrHolder<JyutpingIME>(q), dict_(std::move(dict)),
-          model_(std::move(model)), decoder_(std::make_unique<JyutpingDecoder>(
-                                        dict_.get(), model_.get())) {}
-
-    FCITX_DEFINE_SIGNAL_PRIVATE(JyutpingIME, optionChanged);
-
-    std::unique_ptr<JyutpingDictionary> dict_;
-    std::unique_ptr<UserLanguageModel> model_;
-    std::unique_ptr<JyutpingDecoder> decoder_;
-    bool innerSegment_ = true;
-    size_t nbest_ = 1;
-    size_t beamSize_ = Decoder::beamSizeDefault;
-    size_t frameSize_ = Decoder::frameSizeDefault;
-    float maxDistance_ = std::numeric_limits<float>::max();
-    float minPath_ = -std::numeric_limits<float>::max();
-};
-
 JyutpingIME::JyutpingIME(std::unique_ptr<JyutpingDictionary> dict,
                          std::unique_ptr<UserLanguageModel> model)
     : d_ptr(std::make_unique<JyutpingIMEPrivate>(this, std::move(dict),
@@ -115,6 +96,21 @@ void JyutpingIME::setFrameSize(size_t n) {
     }
 }
 
+size_t JyutpingIME::wordLimit() const {
+    FCITX_D();
+    return d->wordLimit_;
+}
+
+void JyutpingIME::setWordLimit(size_t n) {
+    FCITX_D();
+    if (d->wordLimit_ != n) {
+        d->wordLimit_ = n;
+        // Cached results are matched with the old limit.
+        d->clearSharedMatchCache();
+        emit<JyutpingIME::optionChanged>();
+    }
+}
+
 void JyutpingIME::setScoreFilter(float maxDistance, float minPath) {
     FCITX_D();
     if (d->maxDistance_ != maxDistance || d->minPath_ != minPath) {
@@ -133,5 +129,67 @@ float JyutpingIME::minPath() const {
     FCITX_D();
     return d->minPath_;
 }
+
+void JyutpingIME::setUpdateStatsCallback(
+    JyutpingUpdateStatsCallback callback) {
+    FCITX_D();
+    d->updateStatsCallback_ = std::move(callback);
+}
+
+const JyutpingUpdateStatsCallback &JyutpingIME::updateStatsCallback() const {
+    FCITX_D();
+    return d->updateStatsCallback_;
+}
+
+size_t JyutpingIME::nodeCacheSize() const {
+    FCITX_D();
+    return d->nodeCacheSize_;
+}
+
+void JyutpingIME::setNodeCacheSize(size_t n) {
+    FCITX_D();
+    n = std::max<size_t>(n, 1);
+    if (d->nodeCacheSize_ != n) {
+        d->nodeCacheSize_ = n;
+        emit<JyutpingIME::optionChanged>();
+    }
+}
+
+size_t JyutpingIME::matchCacheSize() const {
+    FCITX_D();
+    return d->matchCacheSize_;
+}
+
+void JyutpingIME::setMatchCacheSize(size_t n) {
+    FCITX_D();
+    n = std::max<size_t>(n, 1);
+    if (d->matchCacheSize_ != n) {
+        d->matchCacheSize_ = n;
+        emit<JyutpingIME::optionChanged>();
+    }
+}
+
+size_t JyutpingIME::sharedMatchCacheSize() const {
+    FCITX_D();
+    return d->sharedMatchCache_.capacity();
+}
+
+void JyutpingIME::setSharedMatchCacheSize(size_t n) {
+    FCITX_D();
+    if (d->sharedMatchCache_.capacity() == n) {
+        return;
+    }
+    d->sharedMatchCache_.setCapacity(n);
+}
+
+std::chrono::microseconds JyutpingIME::updateTimeLimit() const {
+    FCITX_D();
+    return d->updateTimeLimit_;
+}
+
+void JyutpingIME::setUpdateTimeLimit(std::chrono::microseconds limit) {
+    FCITX_D();
+    d->updateTimeLimit_ = std::max(limit, std::chrono::microseconds(0));
+}
 } // namespace jyutping
 } // namespace libime
@@ -10,6 +10,8 @@
 #include "libimejyutping_export.h"
 #include <fcitx-utils/connectableobject.h>
 #include <fcitx-utils/macros.h>
+#include <chrono>
+#include <functional>
 #include <libime/jyutping/jyutpingencoder.h>
 #include <limits>
 #include <memory>
@@ -24,8 +26,34 @@ class JyutpingIMEPrivate;
 class JyutpingDecoder;
 class JyutpingDictionary;
 
+/// \brief Time spent in each stage of a single JyutpingContext update, and
+/// the amount of work done by them.
+struct JyutpingUpdateStats {
+    std::chrono::nanoseconds parse{0};
+    std::chrono::nanoseconds merge{0};
+    std::chrono::nanoseconds decode{0};
+    std::chrono::nanoseconds candidates{0};
+    // Time spent on matching the dictionaries, which is a part of decode.
+    std::chrono::nanoseconds match{0};
+    // Paths with a match in the dictionaries, reused ones included.
+    size_t paths = 0;
+    // Trie positions of these paths.
+    size_t triePositions = 0;
+    // Words passed to the decoder.
+    size_t words = 0;
+    // Candidates collected, materialized or not, and the ones dropped as
+    // duplicates.
+    size_t candidateCount = 0;
+    size_t duplicates = 0;
+};
+
+using JyutpingUpdateStatsCallback =
+    std::function<void(const JyutpingUpdateStats &)>;
+
 /// \brief Provides shared data for JyutpingContext.
 class LIBIMEJYUTPING_EXPORT JyutpingIME : public fcitx::ConnectableObject {
+    friend class JyutpingMatchContext;
+
 public:
     JyutpingIME(std::unique_ptr<JyutpingDictionary> dict,
                 std::unique_ptr<UserLanguageModel> model);
@@ -39,6 +67,18 @@ public:
     void setBeamSize(size_t n);
     size_t frameSize() const;
     void setFrameSize(size_t n);
+    /// \brief Max number of words matched from dictionary for each path.
+    ///
+    /// Only the best words are kept if the limit is reached, 0 means no
+    /// limit.
+    ///
+    /// Only dictionaries in the mapped or block compressed binary format
+    /// (JyutpingDictFormat::MappedBinary and BlockCompressedBinary) skip the
+    /// words that can't be among the best. Other dictionaries, including
+    /// the user dictionary, still visit all matched words to pick the best
+    /// ones, so the limit only cuts the words passed to the decoder.
+    size_t wordLimit() const;
+    void setWordLimit(size_t n);
     void setScoreFilter(float maxDistance = std::numeric_limits<float>::max(),
                         float minPath = -std::numeric_limits<float>::max());
 
@@ -51,6 +91,41 @@ public:
     UserLanguageModel *model();
     const UserLanguageModel *model() const;
 
+    /// \brief Set a callback that receives stage timings and counters of
+    /// every update.
+    ///
+    /// Stats are only collected when a callback is set.
+    void setUpdateStatsCallback(JyutpingUpdateStatsCallback callback);
+    const JyutpingUpdateStatsCallback &updateStatsCallback() const;
+
+    /// \brief Capacity of the trie position cache of each context.
+    ///
+    /// The capacity is at least 1, counters of the caches can be found in
+    /// JyutpingContext::matchState().
+    size_t nodeCacheSize() const;
+    void setNodeCacheSize(size_t n);
+    /// \brief Capacity of the word match cache of each context.
+    size_t matchCacheSize() const;
+    void setMatchCacheSize(size_t n);
+
+    /// \brief Size of the match result cache shared by all contexts.
+    ///
+    /// Words matched from the system dictionary are cached by the jyutping
+    /// string, so a context can reuse the result of another context. 0
+    /// means disabled, which is the default. Changing it drops the cached
+    /// results, and is safe while other contexts are matching.
+    size_t sharedMatchCacheSize() const;
+    void setSharedMatchCacheSize(size_t n);
+
+    /// \brief Time budget of each JyutpingContext update.
+    ///
+    /// Dictionary matching stops once the budget is used up, and the
+    /// candidates are decoded from what is matched so far. See
+    /// JyutpingContext::candidatesIncomplete(). 0 means no limit, which is
+    /// the default.
+    std::chrono::microseconds updateTimeLimit() const;
+    void setUpdateTimeLimit(std::chrono::microseconds limit);
+
     FCITX_DECLARE_SIGNAL(JyutpingIME, optionChanged, void());
 
 private:
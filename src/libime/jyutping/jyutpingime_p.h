@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2026~2026 CSSlayer <wengxt@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+#ifndef _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGIME_P_H_
+#define _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGIME_P_H_
+
+#include "jyutpingdecoder.h"
+#include "jyutpingdictionary.h"
+#include "jyutpingime.h"
+#include "jyutpingmatchstate.h"
+#include "jyutpingmatchstate_p.h"
+#include "libime/core/userlanguagemodel.h"
+#include <fcitx-utils/connectableobject.h>
+#include <fcitx-utils/macros.h>
+#include <limits>
+#include <memory>
+
+namespace libime {
+namespace jyutping {
+
+class JyutpingIMEPrivate : fcitx::QPtrHolder<JyutpingIME> {
+public:
+    JyutpingIMEPrivate(JyutpingIME *q, std::unique_ptr<JyutpingDictionary> dict,
+                       std::unique_ptr<UserLanguageModel> model)
+        : fcitx::QPtrHolder<JyutpingIME>(q), dict_(std::move(dict)),
+          model_(std::move(model)), decoder_(std::make_unique<JyutpingDecoder>(
+                                        dict_.get(), model_.get())) {
+        conn_ = dict_->connect<JyutpingDictionary::dictionaryChanged>(
+            [this](size_t idx) {
+                if (idx == JyutpingDictionary::SystemDict) {
+                    clearSharedMatchCache();
+                }
+            });
+    }
+
+    void clearSharedMatchCache() { sharedMatchCache_.clear(); }
+
+    FCITX_DEFINE_SIGNAL_PRIVATE(JyutpingIME, optionChanged);
+
+    std::unique_ptr<JyutpingDictionary> dict_;
+    std::unique_ptr<UserLanguageModel> model_;
+    std::unique_ptr<JyutpingDecoder> decoder_;
+    bool innerSegment_ = true;
+    size_t nbest_ = 1;
+    size_t beamSize_ = Decoder::beamSizeDefault;
+    size_t frameSize_ = Decoder::frameSizeDefault;
+    size_t wordLimit_ = 0;
+    float maxDistance_ = std::numeric_limits<float>::max();
+    float minPath_ = -std::numeric_limits<float>::max();
+    JyutpingUpdateStatsCallback updateStatsCallback_;
+    size_t nodeCacheSize_ = JyutpingMatchState::cacheSizeDefault;
+    size_t matchCacheSize_ = JyutpingMatchState::cacheSizeDefault;
+    std::chrono::microseconds updateTimeLimit_{0};
+    // Never replaced, contexts refer to it while matching.
+    JyutpingSharedMatchCache sharedMatchCache_;
+    fcitx::ScopedConnection conn_;
+};
+
+} // namespace jyutping
+} // namespace libime
+
+#endif // _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGIME_P_H_
@@ -48,5 +48,22 @@ void JyutpingMatchState::discardDictionary(size_t idx) {
     d->nodeCacheMap_.erase(d->context_->ime()->dict()->trie(idx));
 }
 
+const JyutpingMatchCacheStats &JyutpingMatchState::nodeCacheStats() const {
+    FCITX_D();
+    return d->nodeCacheStats_;
+}
+
+const JyutpingMatchCacheStats &JyutpingMatchState::matchCacheStats() const {
+    FCITX_D();
+    return d->matchCacheStats_;
+}
+
+void JyutpingMatchState::resetCacheStats() {
+    FCITX_D();
+    for (auto *stats : {&d->nodeCacheStats_, &d->matchCacheStats_}) {
+        stats->hits = stats->misses = stats->evictions = 0;
+    }
+}
+
 } // namespace jyutping
 } // namespace libime
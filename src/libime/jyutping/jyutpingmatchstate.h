@@ -21,11 +21,24 @@ namespace jyutping {
 class JyutpingMatchStatePrivate;
 class JyutpingContext;
 
+/// \brief Counters of a cache in JyutpingMatchState.
+struct JyutpingMatchCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    // Estimated size of the entries currently in the cache.
+    size_t bytes = 0;
+};
+
 // Provides caching mechanism used by JyutpingContext.
 class LIBIMEJYUTPING_EXPORT JyutpingMatchState {
     friend class JyutpingMatchContext;
+    friend class JyutpingContext;
 
 public:
+    // Default capacity of each cache.
+    static constexpr size_t cacheSizeDefault = 80;
+
     JyutpingMatchState(JyutpingContext *context);
     ~JyutpingMatchState();
 
@@ -39,6 +52,13 @@ public:
     // dictionary.
     void discardDictionary(size_t idx);
 
+    // Cache of trie positions matched by a jyutping string.
+    const JyutpingMatchCacheStats &nodeCacheStats() const;
+    // Cache of words matched by a jyutping string.
+    const JyutpingMatchCacheStats &matchCacheStats() const;
+    // Reset hits, misses and evictions of all caches.
+    void resetCacheStats();
+
 private:
     std::unique_ptr<JyutpingMatchStatePrivate> d_ptr;
     FCITX_DECLARE_PRIVATE(JyutpingMatchState);
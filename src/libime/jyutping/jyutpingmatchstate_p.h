@@ -7,13 +7,17 @@
 #ifndef _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGMATCHSTATE_P_H_
 #define _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGMATCHSTATE_P_H_
 
+#include "jyutpingpackedtrie_p.h"
 #include <fcitx-utils/macros.h>
+#include <chrono>
 #include <libime/core/lattice.h>
 #include <libime/core/lrucache.h>
 #include <libime/jyutping/jyutpingdictionary.h>
+#include <libime/jyutping/jyutpingime.h>
 #include <libime/jyutping/jyutpingmatchstate.h>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
 namespace libime {
 
@@ -24,11 +28,11 @@ using JyutpingTriePositions = std::vector<JyutpingTriePosition>;
 
 // Matching result for a specific JyutpingTrie.
 struct MatchedJyutpingTrieNodes {
-    MatchedJyutpingTrieNodes(const JyutpingTrie *trie, size_t size)
+    MatchedJyutpingTrieNodes(JyutpingTrieRef trie, size_t size)
         : trie_(trie), size_(size) {}
     FCITX_INLINE_DEFINE_DEFAULT_DTOR_COPY_AND_MOVE(MatchedJyutpingTrieNodes)
 
-    const JyutpingTrie *trie_;
+    JyutpingTrieRef trie_;
     JyutpingTriePositions triePositions_;
 
     // Size of syllables.
@@ -51,7 +55,7 @@ struct JyutpingMatchResult {
 // class to store current SegmentGraphPath leads to this match and the match
 // reuslt.
 struct MatchedJyutpingPath {
-    MatchedJyutpingPath(const JyutpingTrie *trie, size_t size,
+    MatchedJyutpingPath(JyutpingTrieRef trie, size_t size,
                         SegmentGraphPath path)
         : result_(std::make_shared<MatchedJyutpingTrieNodes>(trie, size)),
           path_(std::move(path)) {}
@@ -64,7 +68,7 @@ struct MatchedJyutpingPath {
 
     auto &triePositions() { return result_->triePositions_; }
     const auto &triePositions() const { return result_->triePositions_; }
-    const JyutpingTrie *trie() const { return result_->trie_; }
+    const JyutpingTrieRef &trie() const { return result_->trie_; }
 
     // Size of syllables. not necessarily equal to size of path_, because there
     // may be separators.
@@ -88,6 +92,28 @@ public:
     }
 };
 
+// Value of the caches in JyutpingMatchState. The estimated size of the entry
+// is counted in the bytes of the cache as long as it is in the cache.
+template <typename T>
+class JyutpingCachedValue {
+public:
+    JyutpingCachedValue(T value, size_t bytes, JyutpingMatchCacheStats &stats)
+        : value_(std::move(value)), bytes_(bytes), stats_(&stats) {
+        stats_->bytes += bytes_;
+    }
+    JyutpingCachedValue(JyutpingCachedValue &&other) noexcept
+        : value_(std::move(other.value_)),
+          bytes_(std::exchange(other.bytes_, 0)), stats_(other.stats_) {}
+    ~JyutpingCachedValue() { stats_->bytes -= bytes_; }
+
+    T &value() { return value_; }
+
+private:
+    T value_;
+    size_t bytes_;
+    JyutpingMatchCacheStats *stats_;
+};
+
 // A list of all search paths
 typedef std::vector<MatchedJyutpingPath> MatchedJyutpingPaths;
 
@@ -99,25 +125,95 @@ typedef std::unordered_map<const SegmentGraphNode *, MatchedJyutpingPaths>
 // JyutpingTrieNode
 typedef std::unordered_map<
     const JyutpingTrie *,
-    LRUCache<std::string, std::shared_ptr<MatchedJyutpingTrieNodes>,
+    LRUCache<std::string,
+             JyutpingCachedValue<std::shared_ptr<MatchedJyutpingTrieNodes>>,
              JyutpingStringHasher>>
     JyutpingTrieNodeCache;
 
+// Matched words of a path, may be shared between caches.
+typedef std::shared_ptr<std::vector<JyutpingMatchResult>> JyutpingMatchResults;
+
 // A cache for JyutpingMatchResult.
 typedef std::unordered_map<
     const JyutpingTrie *,
-    LRUCache<std::string, std::vector<JyutpingMatchResult>,
+    LRUCache<std::string, JyutpingCachedValue<JyutpingMatchResults>,
              JyutpingStringHasher>>
     JyutpingMatchResultCache;
 
+// Match results of system dictionary shared by all contexts of a
+// JyutpingIME. Like the rest of JyutpingIME, its contexts are expected to be
+// used from a single thread. Word index of the results is filled before
+// insertion, so they are never modified later.
+//
+// The object lives as long as the JyutpingIME, so contexts can keep a
+// pointer to it. Capacity 0 means disabled.
+class JyutpingSharedMatchCache {
+public:
+    using Cache =
+        LRUCache<std::string, JyutpingMatchResults, JyutpingStringHasher>;
+
+    JyutpingMatchResults find(const std::string &jyutpings) {
+        if (!cache_) {
+            return nullptr;
+        }
+        auto *result = cache_->find(jyutpings);
+        return result ? *result : nullptr;
+    }
+
+    void insert(const std::string &jyutpings, JyutpingMatchResults results) {
+        if (cache_) {
+            cache_->insert(jyutpings, std::move(results));
+        }
+    }
+
+    void clear() {
+        if (cache_) {
+            cache_->clear();
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Cached results are dropped, LRUCache can't be resized.
+    void setCapacity(size_t capacity) {
+        cache_ = capacity ? std::make_unique<Cache>(capacity) : nullptr;
+        capacity_ = capacity;
+    }
+
+private:
+    size_t capacity_ = 0;
+    std::unique_ptr<Cache> cache_;
+};
+
+// Buffers reused by every step of matching. An edge that doesn't lead to
+// any trie position doesn't need to allocate, and a kept result is copied
+// with its exact size.
+struct JyutpingMatchScratch {
+    JyutpingTriePositions positions_;
+    SegmentGraphPath segmentPath_;
+};
+
 class JyutpingMatchStatePrivate {
 public:
     JyutpingMatchStatePrivate(JyutpingContext *context) : context_(context) {}
 
     JyutpingContext *context_;
+    // Referred by the cached values, so it need to outlive the caches.
+    JyutpingMatchCacheStats nodeCacheStats_;
+    JyutpingMatchCacheStats matchCacheStats_;
     NodeToMatchedJyutpingPathsMap matchedPaths_;
     JyutpingTrieNodeCache nodeCacheMap_;
     JyutpingMatchResultCache matchCacheMap_;
+    // Kept with the state so its capacity is reused by later updates.
+    JyutpingMatchScratch scratch_;
+    // Where matching is counted, only set during an update that collects
+    // stats.
+    JyutpingUpdateStats *stats_ = nullptr;
+    // Matching stops at the deadline of current update, and marks it as
+    // timed out.
+    std::chrono::steady_clock::time_point deadline_ =
+        std::chrono::steady_clock::time_point::max();
+    bool timedOut_ = false;
 };
 
 } // namespace jyutping
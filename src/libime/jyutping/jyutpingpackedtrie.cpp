@@ -0,0 +1,459 @@
+/*
+ * SPDX-FileCopyrightText: 2026~2026 CSSlayer <wengxt@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+
+#include "jyutpingpackedtrie_p.h"
+#include "utils_p.h"
+#include "zstdfilter.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <fcitx-utils/log.h>
+#include <fcitx-utils/misc.h>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <zstd.h>
+
+namespace libime {
+namespace jyutping {
+
+namespace {
+
+// Header of packed trie: node count, entry count, offset of node data.
+constexpr size_t packedTrieHeaderSize = sizeof(uint32_t) * 3;
+
+// Header of compressed packed trie: node count, entry count, nodes per block,
+// block count. It is followed by block count + 1 offsets of compressed
+// blocks, and the compressed blocks.
+constexpr size_t compressedTrieHeaderSize = sizeof(uint32_t) * 4;
+
+size_t alignedNodeOffset(size_t offset) {
+    offset += packedTrieHeaderSize;
+    return (offset + JyutpingPackedTrie::alignment - 1) /
+           JyutpingPackedTrie::alignment * JyutpingPackedTrie::alignment;
+}
+
+std::atomic<uint64_t> nextPackedTrieId{1};
+
+// Blocks last used by the current thread, most recent first.
+struct RecentBlock {
+    uint64_t trie = 0;
+    size_t index = 0;
+    std::shared_ptr<const std::vector<JyutpingPackedTrieNode>> block;
+};
+thread_local std::array<RecentBlock, 2> recentBlocks;
+
+uint32_t readBE32(const char *data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return be32toh(value);
+}
+
+} // namespace
+
+JyutpingPackedTrie::JyutpingPackedTrie() : id_(nextPackedTrieId++) {}
+
+JyutpingPackedTrie::JyutpingPackedTrie(const JyutpingTrie &trie)
+    : JyutpingPackedTrie() {
+    std::vector<std::pair<std::string, value_type>> entries;
+    entries.reserve(trie.size());
+    std::string buf;
+    trie.foreach([&trie, &buf, &entries](value_type value, size_t len,
+                                         position_type pos) {
+        trie.suffix(buf, len, pos);
+        entries.emplace_back(buf, value);
+        return true;
+    });
+    // std::string compares as unsigned char, which matches the label order.
+    std::sort(entries.begin(), entries.end());
+
+    auto nodes = std::make_shared<Block>();
+    auto newNode = [&nodes](uint32_t parent, uint8_t label, size_t depth) {
+        if (depth > UINT16_MAX || nodes->size() >= UINT32_MAX) {
+            throw std::invalid_argument("Dictionary is too large to pack.");
+        }
+        JyutpingPackedTrieNode node;
+        node.parent = htole32(parent);
+        node.end = 0;
+        node.value = 0;
+        node.label = label;
+        node.flags = 0;
+        node.depth = htole16(static_cast<uint16_t>(depth));
+        nodes->push_back(node);
+        return static_cast<uint32_t>(nodes->size() - 1);
+    };
+    // Nodes on the path of the last inserted key.
+    std::vector<uint32_t> stack;
+    stack.push_back(newNode(0, 0, 0));
+    std::string_view prev;
+    for (const auto &[key, value] : entries) {
+        auto mismatch =
+            std::mismatch(prev.begin(), prev.end(), key.begin(), key.end());
+        size_t common = std::distance(prev.begin(), mismatch.first);
+        while (stack.size() > common + 1) {
+            (*nodes)[stack.back()].end =
+                htole32(static_cast<uint32_t>(nodes->size()));
+            stack.pop_back();
+        }
+        for (size_t i = common; i < key.size(); i++) {
+            stack.push_back(
+                newNode(stack.back(), static_cast<uint8_t>(key[i]), i + 1));
+        }
+        auto &node = (*nodes)[stack.back()];
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        node.value = htole32(bits);
+        node.flags |= hasValueFlag;
+        prev = key;
+    }
+    while (!stack.empty()) {
+        (*nodes)[stack.back()].end =
+            htole32(static_cast<uint32_t>(nodes->size()));
+        stack.pop_back();
+    }
+
+    // Annotate nodes without value with the max value of their subtree.
+    // Parent always comes before its children, so it can be done in one
+    // reversed pass.
+    std::vector<value_type> subtreeMax(
+        nodes->size(), -std::numeric_limits<value_type>::infinity());
+    for (size_t i = nodes->size(); i-- > 0;) {
+        auto &node = (*nodes)[i];
+        if (node.flags & hasValueFlag) {
+            subtreeMax[i] = std::max(subtreeMax[i], nodeValue(node));
+        } else if (subtreeMax[i] !=
+                   -std::numeric_limits<value_type>::infinity()) {
+            uint32_t bits;
+            memcpy(&bits, &subtreeMax[i], sizeof(bits));
+            node.value = htole32(bits);
+            node.flags |= hasMaxFlag;
+        }
+        if (i > 0) {
+            auto &parentMax = subtreeMax[le32toh(node.parent)];
+            parentMax = std::max(parentMax, subtreeMax[i]);
+        }
+    }
+
+    nodes_ = nodes->data();
+    nodeCount_ = nodes->size();
+    size_ = entries.size();
+    storage_ = std::move(nodes);
+}
+
+std::unique_ptr<JyutpingPackedTrie>
+JyutpingPackedTrie::readBlockIndex(std::istream &in) {
+    uint32_t nodeCount, size, blockNodes, blockCount;
+    throw_if_io_fail(unmarshall(in, nodeCount));
+    throw_if_io_fail(unmarshall(in, size));
+    throw_if_io_fail(unmarshall(in, blockNodes));
+    throw_if_io_fail(unmarshall(in, blockCount));
+    if (nodeCount == 0 || blockNodes == 0 ||
+        blockCount != (nodeCount + blockNodes - 1) / blockNodes) {
+        throw std::invalid_argument("Invalid packed jyutping trie.");
+    }
+
+    std::unique_ptr<JyutpingPackedTrie> result(new JyutpingPackedTrie);
+    result->nodeCount_ = nodeCount;
+    result->size_ = size;
+    result->blockNodes_ = blockNodes;
+    for (size_t i = 0; i <= blockCount; i++) {
+        uint32_t blockOffset;
+        throw_if_io_fail(unmarshall(in, blockOffset));
+        if (i == 0 ? blockOffset != 0
+                   : blockOffset <= result->blockOffsets_.back()) {
+            throw std::invalid_argument("Invalid packed jyutping trie.");
+        }
+        result->blockOffsets_.push_back(blockOffset);
+    }
+    return result;
+}
+
+void JyutpingPackedTrie::checkNodes(const JyutpingPackedTrieNode *nodes,
+                                    size_t begin, size_t count) const {
+    for (size_t i = 0; i < count; i++) {
+        if (!validNode(nodes[i], begin + i)) {
+            throw std::invalid_argument("Invalid packed jyutping trie.");
+        }
+    }
+}
+
+void JyutpingPackedTrie::checkBlocks() const {
+    for (size_t i = 0; i + 1 < blockOffsets_.size(); i++) {
+        const char *block = blockData_ + blockOffsets_[i];
+        const size_t blockSize = blockOffsets_[i + 1] - blockOffsets_[i];
+        const size_t nodes =
+            std::min(blockNodes_, nodeCount_ - i * blockNodes_);
+        // Each block is a single frame that decompresses to its nodes. The
+        // content of the frame is checked against its checksum when it is
+        // decompressed.
+        if (ZSTD_findFrameCompressedSize(block, blockSize) != blockSize ||
+            ZSTD_getFrameContentSize(block, blockSize) !=
+                sizeof(JyutpingPackedTrieNode) * nodes) {
+            throw std::invalid_argument("Invalid packed jyutping trie.");
+        }
+    }
+}
+
+void JyutpingPackedTrie::checkRoot() const {
+    if (le32toh(node(0).end) != nodeCount_) {
+        throw std::invalid_argument("Invalid packed jyutping trie.");
+    }
+}
+
+std::unique_ptr<JyutpingPackedTrie>
+JyutpingPackedTrie::load(std::istream &in, size_t offset, bool compressed) {
+    if (compressed) {
+        auto result = readBlockIndex(in);
+        auto data =
+            std::make_shared<std::vector<char>>(result->blockOffsets_.back());
+        throw_if_io_fail(in.read(data->data(), data->size()));
+        result->blockData_ = data->data();
+        result->storage_ = std::move(data);
+        result->checkBlocks();
+        result->checkRoot();
+        return result;
+    }
+
+    uint32_t nodeCount, size, nodeOffset;
+    throw_if_io_fail(unmarshall(in, nodeCount));
+    throw_if_io_fail(unmarshall(in, size));
+    throw_if_io_fail(unmarshall(in, nodeOffset));
+    if (nodeCount == 0 || nodeOffset < offset + packedTrieHeaderSize) {
+        throw std::invalid_argument("Invalid packed jyutping trie.");
+    }
+    throw_if_io_fail(in.ignore(nodeOffset - offset - packedTrieHeaderSize));
+
+    auto nodes = std::make_shared<Block>(nodeCount);
+    throw_if_io_fail(in.read(reinterpret_cast<char *>(nodes->data()),
+                             sizeof(JyutpingPackedTrieNode) * nodeCount));
+
+    std::unique_ptr<JyutpingPackedTrie> result(new JyutpingPackedTrie);
+    result->nodes_ = nodes->data();
+    result->nodeCount_ = nodeCount;
+    result->size_ = size;
+    result->storage_ = std::move(nodes);
+    result->checkNodes(result->nodes_, 0, nodeCount);
+    result->checkRoot();
+    return result;
+}
+
+std::unique_ptr<JyutpingPackedTrie>
+JyutpingPackedTrie::map(const char *filename, size_t offset, bool compressed) {
+    auto file = std::make_shared<boost::iostreams::mapped_file_source>();
+    try {
+        file->open(filename);
+    } catch (const std::exception &) {
+        throw std::ios_base::failure("io fail");
+    }
+    if (file->size() < offset) {
+        throw std::invalid_argument("Invalid packed jyutping trie.");
+    }
+
+    if (compressed) {
+        boost::iostreams::stream<boost::iostreams::array_source> in(
+            file->data() + offset, file->size() - offset);
+        auto result = readBlockIndex(in);
+        const size_t dataOffset =
+            offset + compressedTrieHeaderSize +
+            sizeof(uint32_t) * result->blockOffsets_.size();
+        if (dataOffset > file->size() ||
+            file->size() - dataOffset < result->blockOffsets_.back()) {
+            throw std::invalid_argument("Invalid packed jyutping trie.");
+        }
+        result->blockData_ = file->data() + dataOffset;
+        result->storage_ = std::move(file);
+        result->checkBlocks();
+        result->checkRoot();
+        return result;
+    }
+
+    if (file->size() - offset < packedTrieHeaderSize) {
+        throw std::invalid_argument("Invalid packed jyutping trie.");
+    }
+    const char *header = file->data() + offset;
+    uint32_t nodeCount = readBE32(header);
+    uint32_t size = readBE32(header + sizeof(uint32_t));
+    uint32_t nodeOffset = readBE32(header + sizeof(uint32_t) * 2);
+    if (nodeCount == 0 || nodeOffset % alignof(JyutpingPackedTrieNode) != 0 ||
+        nodeOffset < offset + packedTrieHeaderSize ||
+        nodeOffset > file->size() ||
+        (file->size() - nodeOffset) / sizeof(JyutpingPackedTrieNode) <
+            nodeCount) {
+        throw std::invalid_argument("Invalid packed jyutping trie.");
+    }
+
+    std::unique_ptr<JyutpingPackedTrie> result(new JyutpingPackedTrie);
+    result->nodes_ =
+        reinterpret_cast<const JyutpingPackedTrieNode *>(file->data() +
+                                                         nodeOffset);
+    result->nodeCount_ = nodeCount;
+    result->size_ = size;
+    result->storage_ = std::move(file);
+    result->checkRoot();
+    return result;
+}
+
+void JyutpingPackedTrie::save(std::ostream &out, size_t offset,
+                              bool compressed) const {
+    if (compressed) {
+        const size_t blockCount =
+            (nodeCount_ + nodesPerBlock - 1) / nodesPerBlock;
+        fcitx::UniqueCPtr<ZSTD_CCtx, &ZSTD_freeCCtx> cctx(ZSTD_createCCtx());
+        ZSTDError::check(
+            ZSTD_CCtx_setParameter(cctx.get(), ZSTD_c_checksumFlag, 1));
+        std::vector<std::string> blocks;
+        blocks.reserve(blockCount);
+        for (size_t i = 0; i < blockCount; i++) {
+            const size_t begin = i * nodesPerBlock;
+            auto nodes =
+                copyNodes(begin, std::min(begin + nodesPerBlock, nodeCount_));
+            const size_t nodesSize =
+                sizeof(JyutpingPackedTrieNode) * nodes.size();
+            std::string block(ZSTD_compressBound(nodesSize), '\0');
+            const size_t blockSize =
+                ZSTD_compress2(cctx.get(), block.data(), block.size(),
+                               nodes.data(), nodesSize);
+            ZSTDError::check(blockSize);
+            block.resize(blockSize);
+            blocks.push_back(std::move(block));
+        }
+
+        throw_if_io_fail(marshall(out, static_cast<uint32_t>(nodeCount_)));
+        throw_if_io_fail(marshall(out, static_cast<uint32_t>(size_)));
+        throw_if_io_fail(marshall(out, static_cast<uint32_t>(nodesPerBlock)));
+        throw_if_io_fail(marshall(out, static_cast<uint32_t>(blockCount)));
+        size_t blockOffset = 0;
+        throw_if_io_fail(marshall(out, static_cast<uint32_t>(blockOffset)));
+        for (const auto &block : blocks) {
+            blockOffset += block.size();
+            if (blockOffset > UINT32_MAX) {
+                throw std::invalid_argument("Dictionary is too large to pack.");
+            }
+            throw_if_io_fail(marshall(out, static_cast<uint32_t>(blockOffset)));
+        }
+        for (const auto &block : blocks) {
+            throw_if_io_fail(out.write(block.data(), block.size()));
+        }
+        return;
+    }
+
+    const auto nodeOffset = alignedNodeOffset(offset);
+    throw_if_io_fail(marshall(out, static_cast<uint32_t>(nodeCount_)));
+    throw_if_io_fail(marshall(out, static_cast<uint32_t>(size_)));
+    throw_if_io_fail(marshall(out, static_cast<uint32_t>(nodeOffset)));
+    std::string padding(nodeOffset - offset - packedTrieHeaderSize, '\0');
+    throw_if_io_fail(out.write(padding.data(), padding.size()));
+    if (nodes_) {
+        throw_if_io_fail(
+            out.write(reinterpret_cast<const char *>(nodes_),
+                      sizeof(JyutpingPackedTrieNode) * nodeCount_));
+        return;
+    }
+    for (size_t i = 0; i < nodeCount_; i += blockNodes_) {
+        auto nodes = copyNodes(i, std::min(i + blockNodes_, nodeCount_));
+        throw_if_io_fail(
+            out.write(reinterpret_cast<const char *>(nodes.data()),
+                      sizeof(JyutpingPackedTrieNode) * nodes.size()));
+    }
+}
+
+JyutpingPackedTrieNode
+JyutpingPackedTrie::blockNode(position_type pos) const {
+    const size_t index = pos / blockNodes_;
+    auto &recent = recentBlocks;
+    if (recent[0].trie != id_ || recent[0].index != index) {
+        if (recent[1].trie == id_ && recent[1].index == index) {
+            std::swap(recent[0], recent[1]);
+        } else {
+            recent[1] = std::move(recent[0]);
+            recent[0] = {id_, index, cachedBlock(index)};
+        }
+    }
+    return (*recent[0].block)[pos % blockNodes_];
+}
+
+std::shared_ptr<const JyutpingPackedTrie::Block>
+JyutpingPackedTrie::cachedBlock(size_t index) const {
+    {
+        std::lock_guard<std::mutex> lock(blockCacheMutex_);
+        if (auto *block = blockCache_.find(index)) {
+            return *block;
+        }
+    }
+    // Decompress without holding the lock, if another thread decompressed
+    // the same block in the meantime, insert is a no-op.
+    auto block = decompressBlock(index);
+    {
+        std::lock_guard<std::mutex> lock(blockCacheMutex_);
+        blockCache_.insert(index, block);
+    }
+    return block;
+}
+
+std::shared_ptr<const JyutpingPackedTrie::Block>
+JyutpingPackedTrie::decompressBlock(size_t index) const {
+    const size_t begin = blockOffsets_[index];
+    const size_t end = blockOffsets_[index + 1];
+    const size_t first = index * blockNodes_;
+    auto block = std::make_shared<Block>(
+        std::min(blockNodes_, nodeCount_ - first));
+    const size_t blockSize = sizeof(JyutpingPackedTrieNode) * block->size();
+    const size_t result = ZSTD_decompress(block->data(), blockSize,
+                                          blockData_ + begin, end - begin);
+    bool valid = !ZSTD_isError(result) && result == blockSize;
+    for (size_t i = 0; valid && i < block->size(); i++) {
+        valid = validNode((*block)[i], first + i);
+    }
+    if (!valid) [[unlikely]] {
+        // Blocks are decompressed in the middle of a lookup, where nothing
+        // expects an exception. A damaged block is read as leaves without
+        // value instead, the block index and frame headers are checked when
+        // loading already.
+        FCITX_ERROR() << "Damaged block " << index
+                      << " in packed jyutping trie.";
+        for (size_t i = 0; i < block->size(); i++) {
+            auto &node = (*block)[i];
+            node.parent = 0;
+            node.end = htole32(static_cast<uint32_t>(first + i + 1));
+            node.flags = 0;
+        }
+    }
+    return block;
+}
+
+JyutpingPackedTrie::Block JyutpingPackedTrie::copyNodes(size_t begin,
+                                                        size_t end) const {
+    if (nodes_) {
+        return {nodes_ + begin, nodes_ + end};
+    }
+    Block nodes;
+    nodes.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+        nodes.push_back(blockNode(i));
+    }
+    return nodes;
+}
+
+JyutpingTrie JyutpingPackedTrie::toDATrie() const {
+    JyutpingTrie trie;
+    std::string buf;
+    foreach([this, &trie, &buf](value_type value, size_t len,
+                                position_type pos) {
+        suffix(buf, len, pos);
+        trie.set(buf.data(), buf.size(), value);
+        return true;
+    });
+    return trie;
+}
+
+} // namespace jyutping
+} // namespace libime
@@ -0,0 +1,373 @@
+/*
+ * SPDX-FileCopyrightText: 2026~2026 CSSlayer <wengxt@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ *
+ */
+#ifndef _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGPACKEDTRIE_P_H_
+#define _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGPACKEDTRIE_P_H_
+
+#include "endian_p.h"
+#include "libimejyutping_export.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <libime/core/lrucache.h>
+#include <libime/jyutping/jyutpingdictionary.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace libime {
+namespace jyutping {
+
+// On disk node of JyutpingPackedTrie, all fields are little endian.
+//
+// Nodes are stored in preorder, and children of a node are sorted by label.
+// So the subtree of node i is the range [i, end), the first child of node i
+// is i + 1 and the next sibling of node i is end.
+//
+// A node without value may store the max value in its subtree instead, which
+// is marked by a flag.
+struct JyutpingPackedTrieNode {
+    uint32_t parent;
+    uint32_t end;
+    uint32_t value;
+    uint8_t label;
+    uint8_t flags;
+    uint16_t depth;
+};
+
+static_assert(sizeof(JyutpingPackedTrieNode) == 16,
+              "JyutpingPackedTrieNode need to be 16 bytes.");
+
+// A read only trie that can be queried in place from a memory mapped file.
+// It provides a subset of DATrie's interface that is used by
+// JyutpingDictionary.
+//
+// Node data is either stored flat, or split into blocks that are compressed
+// independently. Blocks are only decompressed when they are accessed, and
+// kept in a bounded cache.
+//
+// It's exported so the inline lookup functions can be used by benchmarks.
+class LIBIMEJYUTPING_EXPORT JyutpingPackedTrie {
+public:
+    using value_type = JyutpingTrie::value_type;
+    using position_type = JyutpingTrie::position_type;
+
+    // Alignment of flat node data within the file.
+    static constexpr size_t alignment = 4096;
+    // Number of nodes in a compressed block when saving.
+    static constexpr size_t nodesPerBlock = 4096;
+    // Number of decompressed blocks to keep in memory.
+    static constexpr size_t blockCacheSize = 64;
+
+    explicit JyutpingPackedTrie(const JyutpingTrie &trie);
+
+    // offset is the number of bytes in the file before the packed trie data,
+    // which is used to align the flat node data to page boundary.
+    static std::unique_ptr<JyutpingPackedTrie>
+    load(std::istream &in, size_t offset, bool compressed);
+    static std::unique_ptr<JyutpingPackedTrie>
+    map(const char *filename, size_t offset, bool compressed);
+    void save(std::ostream &out, size_t offset, bool compressed) const;
+
+    JyutpingTrie toDATrie() const;
+
+    size_t size() const { return size_; }
+
+    value_type traverse(const char *key, size_t len,
+                        position_type &pos) const {
+        for (size_t i = 0; i < len; i++) {
+            const auto label = static_cast<uint8_t>(key[i]);
+            const auto end = le32toh(node(pos).end);
+            auto child = pos + 1;
+            while (child < end) {
+                const auto current = node(child);
+                if (current.label == label) {
+                    break;
+                }
+                if (current.label > label) {
+                    return JyutpingTrie::noPath();
+                }
+                child = le32toh(current.end);
+            }
+            if (child >= end) {
+                return JyutpingTrie::noPath();
+            }
+            pos = child;
+        }
+        return nodeValue(node(pos));
+    }
+
+    template <typename Callback>
+    bool foreach(const Callback &callback, position_type pos = 0) const {
+        const auto start = node(pos);
+        const size_t depth = le16toh(start.depth);
+        for (auto i = pos, e = static_cast<position_type>(le32toh(start.end));
+             i < e; i++) {
+            const auto current = node(i);
+            if (!(current.flags & hasValueFlag)) {
+                continue;
+            }
+            if (!callback(nodeValue(current), le16toh(current.depth) - depth,
+                          i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Same as foreach, but values are visited in descending order until
+    // callback returns false. Subtrees that can't contain a better value are
+    // not visited, if the nodes are annotated with the max value of their
+    // subtree.
+    template <typename Callback>
+    bool foreachBest(const Callback &callback, position_type pos = 0) const {
+        // Score, position, and whether score is the value of the node or a
+        // bound of its subtree. Values are popped before bounds if equal.
+        using Item = std::tuple<value_type, bool, position_type>;
+        auto cmp = [](const Item &lhs, const Item &rhs) {
+            if (std::get<0>(lhs) != std::get<0>(rhs)) {
+                return std::get<0>(lhs) < std::get<0>(rhs);
+            }
+            if (std::get<1>(lhs) != std::get<1>(rhs)) {
+                return std::get<1>(lhs) < std::get<1>(rhs);
+            }
+            return std::get<2>(lhs) > std::get<2>(rhs);
+        };
+        std::priority_queue<Item, std::vector<Item>, decltype(cmp)> queue(cmp);
+        const size_t depth = le16toh(node(pos).depth);
+        queue.emplace(nodeBound(pos), false, pos);
+        while (!queue.empty()) {
+            const auto [score, isValue, current] = queue.top();
+            queue.pop();
+            const auto currentNode = node(current);
+            if (isValue) {
+                if (!callback(score, le16toh(currentNode.depth) - depth,
+                              current)) {
+                    return false;
+                }
+                continue;
+            }
+            if (currentNode.flags & hasValueFlag) {
+                queue.emplace(nodeValue(currentNode), true, current);
+            }
+            for (auto child = current + 1,
+                      end = static_cast<position_type>(
+                          le32toh(currentNode.end));
+                 child < end;
+                 child = static_cast<position_type>(le32toh(node(child).end))) {
+                queue.emplace(nodeBound(child), false, child);
+            }
+        }
+        return true;
+    }
+
+    void suffix(std::string &s, size_t len, position_type pos) const {
+        s.resize(len);
+        for (size_t i = len; i > 0; i--) {
+            const auto current = node(pos);
+            s[i - 1] = static_cast<char>(current.label);
+            pos = le32toh(current.parent);
+        }
+    }
+
+private:
+    using Block = std::vector<JyutpingPackedTrieNode>;
+    static constexpr uint8_t hasValueFlag = 1;
+    static constexpr uint8_t hasMaxFlag = 2;
+
+    JyutpingPackedTrie();
+
+    static std::unique_ptr<JyutpingPackedTrie> readBlockIndex(std::istream &in);
+    void checkRoot() const;
+    // Check the frame header of each compressed block.
+    void checkBlocks() const;
+    // Check the links of nodes [begin, begin + count), so a corrupted file
+    // can't make a lookup read out of bounds or loop forever. Mapped flat
+    // nodes are checked by node() instead.
+    void checkNodes(const JyutpingPackedTrieNode *nodes, size_t begin,
+                    size_t count) const;
+
+    // Whether the links of the node at pos are in bounds. Parent comes before
+    // the node, or is 0 for the root, and the subtree is not empty.
+    bool validNode(const JyutpingPackedTrieNode &node, size_t pos) const {
+        const size_t parent = le32toh(node.parent);
+        const size_t end = le32toh(node.end);
+        return (pos == 0 ? parent == 0 : parent < pos) && end > pos &&
+               end <= nodeCount_;
+    }
+
+    JyutpingPackedTrieNode node(position_type pos) const {
+        if (nodes_) {
+            // Mapped nodes are checked as they are read, checking all of them
+            // when loading would read the whole file. A node with invalid
+            // links is read as a leaf without value.
+            auto current = nodes_[pos];
+            if (!validNode(current, pos)) [[unlikely]] {
+                current.parent = 0;
+                current.end = htole32(pos + 1);
+                current.flags = 0;
+            }
+            return current;
+        }
+        return blockNode(pos);
+    }
+    // Nodes are read one at a time, so the blocks last used by the current
+    // thread are kept outside of the locked cache.
+    JyutpingPackedTrieNode blockNode(position_type pos) const;
+    std::shared_ptr<const Block> cachedBlock(size_t index) const;
+    std::shared_ptr<const Block> decompressBlock(size_t index) const;
+    // Copy nodes in [begin, end) to a continuous buffer.
+    Block copyNodes(size_t begin, size_t end) const;
+
+    static value_type nodeValue(const JyutpingPackedTrieNode &node,
+                                bool max = false) {
+        if (!(node.flags & (max ? hasMaxFlag : hasValueFlag))) {
+            return JyutpingTrie::noValue();
+        }
+        uint32_t bits = le32toh(node.value);
+        value_type value;
+        static_assert(sizeof(value) == sizeof(bits));
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Upper bound of the values in the subtree of pos.
+    value_type nodeBound(position_type pos) const {
+        const auto current = node(pos);
+        if (current.flags & hasMaxFlag) {
+            return nodeValue(current, true);
+        }
+        if ((current.flags & hasValueFlag) && le32toh(current.end) == pos + 1) {
+            return nodeValue(current);
+        }
+        // Not annotated, e.g. a file saved by an older version.
+        return std::numeric_limits<value_type>::infinity();
+    }
+
+    // Identifies the trie in the per thread recent blocks, since the address
+    // may be reused.
+    uint64_t id_;
+    // Either a memory mapped file or a heap buffer.
+    std::shared_ptr<const void> storage_;
+    // Flat node data, null if node data is compressed.
+    const JyutpingPackedTrieNode *nodes_ = nullptr;
+    size_t nodeCount_ = 0;
+    size_t size_ = 0;
+
+    // Compressed block i is stored in blockData_ within the range of
+    // [blockOffsets_[i], blockOffsets_[i + 1]).
+    const char *blockData_ = nullptr;
+    size_t blockNodes_ = 0;
+    std::vector<size_t> blockOffsets_;
+    mutable std::mutex blockCacheMutex_;
+    mutable LRUCache<size_t, std::shared_ptr<const Block>> blockCache_{
+        blockCacheSize};
+};
+
+// Read only reference to a dictionary trie. It's backed by a
+// JyutpingPackedTrie if the dictionary is loaded from the packed format,
+// otherwise the DATrie in TrieDictionary.
+class JyutpingTrieRef {
+public:
+    JyutpingTrieRef(const JyutpingTrie *trie,
+                    const JyutpingPackedTrie *packed = nullptr)
+        : trie_(trie), packed_(packed) {}
+
+    // The DATrie owned by TrieDictionary is used as the identity of the
+    // trie, even if it is empty.
+    const JyutpingTrie *key() const { return trie_; }
+    const JyutpingPackedTrie *packed() const { return packed_; }
+
+    size_t size() const { return packed_ ? packed_->size() : trie_->size(); }
+
+    JyutpingTrie::value_type traverse(const char *key, size_t len,
+                                      JyutpingTrie::position_type &pos) const {
+        if (packed_) {
+            return packed_->traverse(key, len, pos);
+        }
+        return trie_->traverse(key, len, pos);
+    }
+
+    template <typename Callback>
+    bool foreach(const Callback &callback,
+                 JyutpingTrie::position_type pos = 0) const {
+        if (packed_) {
+            return packed_->foreach(callback, pos);
+        }
+        return trie_->foreach(callback, pos);
+    }
+
+    // Visit at most limit values in the subtree of pos in descending order.
+    template <typename Callback>
+    void foreachBest(const Callback &callback, size_t limit,
+                     JyutpingTrie::position_type pos = 0) const {
+        if (limit == 0) {
+            return;
+        }
+        if (packed_) {
+            packed_->foreachBest(
+                [&callback, &limit](JyutpingTrie::value_type value, size_t len,
+                                    JyutpingTrie::position_type pos) {
+                    callback(value, len, pos);
+                    return --limit > 0;
+                },
+                pos);
+            return;
+        }
+        // DATrie has no annotation, so all values need to be visited. Only
+        // the best limit ones are kept, in a min heap.
+        using Item = std::tuple<JyutpingTrie::value_type, size_t,
+                                JyutpingTrie::position_type>;
+        auto cmp = [](const Item &lhs, const Item &rhs) {
+            return std::get<0>(lhs) > std::get<0>(rhs);
+        };
+        std::vector<Item> heap;
+        trie_->foreach(
+            [&heap, &cmp, limit](JyutpingTrie::value_type value, size_t len,
+                          JyutpingTrie::position_type pos) {
+                if (heap.size() < limit) {
+                    heap.emplace_back(value, len, pos);
+                    std::push_heap(heap.begin(), heap.end(), cmp);
+                } else if (value > std::get<0>(heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), cmp);
+                    heap.back() = {value, len, pos};
+                    std::push_heap(heap.begin(), heap.end(), cmp);
+                }
+                return true;
+            },
+            pos);
+        // Best first.
+        std::sort_heap(heap.begin(), heap.end(), cmp);
+        for (const auto &[value, len, pos] : heap) {
+            callback(value, len, pos);
+        }
+    }
+
+    void suffix(std::string &s, size_t len,
+                JyutpingTrie::position_type pos) const {
+        if (packed_) {
+            packed_->suffix(s, len, pos);
+        } else {
+            trie_->suffix(s, len, pos);
+        }
+    }
+
+private:
+    const JyutpingTrie *trie_;
+    const JyutpingPackedTrie *packed_;
+};
+
+} // namespace jyutping
+} // namespace libime
+
+#endif // _LIBIME_JYUTPING_LIBIME_JYUTPING_JYUTPINGPACKEDTRIE_P_H_
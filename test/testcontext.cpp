@@ -0,0 +1,301 @@
+/*
+ * SPDX-FileCopyrightText: 2026~2026 CSSlayer <wengxt@gmail.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "libime/core/userlanguagemodel.h"
+#include "libime/jyutping/jyutpingcontext.h"
+#include "libime/jyutping/jyutpingdictionary.h"
+#include "libime/jyutping/jyutpingencoder.h"
+#include "libime/jyutping/jyutpingime.h"
+#include "libime/jyutping/jyutpingmatchstate.h"
+#include "testdir.h"
+#include <algorithm>
+#include <chrono>
+#include <fcitx-utils/log.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace libime;
+using namespace libime::jyutping;
+
+namespace {
+
+// A long input, so that updates take a while.
+constexpr char longInput[] =
+    "ngodeiheoisikfaanneihoumaahoenggongdaaihokgamjattinheihouhou";
+
+std::vector<std::string> candidateStrings(const JyutpingContext &context,
+                                          size_t n) {
+    std::vector<std::string> result;
+    for (const auto &candidate : context.candidatesTo(n)) {
+        result.push_back(candidate.toString());
+    }
+    return result;
+}
+
+void testUpdateTimeLimit(JyutpingIME &ime) {
+    JyutpingContext expect(&ime);
+    expect.type(longInput);
+    FCITX_ASSERT(!expect.candidatesIncomplete());
+
+    ime.setUpdateTimeLimit(std::chrono::microseconds(1));
+    JyutpingContext context(&ime);
+    context.type(longInput);
+    FCITX_ASSERT(context.candidatesIncomplete());
+    // Every step matches more of the input, until it's complete.
+    size_t steps = 0;
+    while (context.candidatesIncomplete()) {
+        FCITX_ASSERT(steps < context.size());
+        context.resumeUpdate();
+        steps++;
+    }
+    FCITX_ASSERT(steps > 1);
+    FCITX_ASSERT(candidateStrings(context, 20) == candidateStrings(expect, 20));
+
+    // Finishing without time limit gives the same.
+    JyutpingContext other(&ime);
+    other.type(longInput);
+    FCITX_ASSERT(other.candidatesIncomplete());
+    other.resumeUpdate();
+    other.completeUpdate();
+    FCITX_ASSERT(!other.candidatesIncomplete());
+    FCITX_ASSERT(candidateStrings(other, 20) == candidateStrings(expect, 20));
+    ime.setUpdateTimeLimit(std::chrono::microseconds::zero());
+}
+
+void testSharedMatchCache(JyutpingIME &ime) {
+    JyutpingContext expect(&ime);
+    expect.type(longInput);
+    const auto candidates = candidateStrings(expect, 20);
+
+    ime.setSharedMatchCacheSize(100);
+    JyutpingContext first(&ime);
+    JyutpingContext second(&ime);
+    first.type(longInput);
+    second.type(longInput);
+    FCITX_ASSERT(candidateStrings(first, 20) == candidates);
+    FCITX_ASSERT(candidateStrings(second, 20) == candidates);
+
+    // Resizing keeps the contexts working.
+    ime.setSharedMatchCacheSize(50);
+    second.clear();
+    second.type(longInput);
+    FCITX_ASSERT(candidateStrings(second, 20) == candidates);
+    ime.setSharedMatchCacheSize(0);
+    first.clear();
+    first.type(longInput);
+    FCITX_ASSERT(candidateStrings(first, 20) == candidates);
+}
+
+// Candidates are materialized lazily, check that they are the same as if all
+// of them were collected and sorted at once.
+void testCandidateOrder(JyutpingIME &ime) {
+    for (const char *input : {"nei", "ngodei", "heoisikfaan", longInput}) {
+        JyutpingContext full(&ime);
+        full.type(input);
+        const auto &candidates = full.candidates();
+        FCITX_ASSERT(candidates.size() > 1);
+
+        // The sentence, followed by all the words ordered by score.
+        FCITX_ASSERT(std::is_sorted(candidates.begin() + 1, candidates.end(),
+                                    std::greater<SentenceResult>()));
+
+        // Words are never the same as the sentence. Words starting from bos
+        // are unique, others are only checked against the words starting
+        // from bos that are not shorter than them.
+        const auto sentence = candidates[0].toString();
+        for (size_t i = 1; i < candidates.size(); i++) {
+            const auto &candidate = candidates[i];
+            const auto word = candidate.toString();
+            const auto *last = candidate.sentence().back();
+            const bool fromBos = last->from()->index() == 0;
+            FCITX_ASSERT(word != sentence) << word;
+            for (size_t j = 1; j < candidates.size(); j++) {
+                const auto &other = candidates[j];
+                const auto *otherLast = other.sentence().back();
+                if (j == i || otherLast->from()->index() != 0 ||
+                    other.toString() != word) {
+                    continue;
+                }
+                FCITX_ASSERT(!fromBos) << word;
+                FCITX_ASSERT(otherLast->to()->index() < last->to()->index())
+                    << word;
+            }
+        }
+
+        for (size_t n : {1, 5, 20, 21, 100}) {
+            JyutpingContext context(&ime);
+            context.type(input);
+            const auto prefix = candidateStrings(context, n);
+            const auto size = std::min(n, candidates.size());
+            FCITX_ASSERT(prefix.size() >= size);
+            for (size_t i = 0; i < size; i++) {
+                FCITX_ASSERT(prefix[i] == candidates[i].toString())
+                    << input << " " << n << " " << i;
+            }
+        }
+    }
+}
+
+// Words matched for each path, identified by the index of its nodes, in
+// descending order of cost.
+using PathWords =
+    std::map<std::vector<size_t>, std::vector<std::pair<float, std::string>>>;
+
+PathWords matchPaths(JyutpingIME &ime, const SegmentGraph &graph) {
+    JyutpingContext context(&ime);
+    JyutpingMatchState state(&context);
+    PathWords result;
+    ime.dict()->matchPrefix(
+        graph,
+        [&result](const SegmentGraphPath &path, WordNode &node, float cost,
+                  std::unique_ptr<LatticeNodeData>) {
+            std::vector<size_t> key;
+            for (const auto *step : path) {
+                key.push_back(step->index());
+            }
+            result[key].emplace_back(cost, node.word());
+            return true;
+        },
+        {}, &state);
+    for (auto &[path, words] : result) {
+        std::sort(words.begin(), words.end(), std::greater<>());
+    }
+    return result;
+}
+
+// With a word limit, each path gets the best words of a full sort.
+void checkWordLimit(JyutpingIME &ime) {
+    for (const char *input : {"nei", "ngodei", "jinhau", "heoisikfaan"}) {
+        const auto graph = JyutpingEncoder::parseUserJyutping(input);
+        ime.setWordLimit(0);
+        const auto all = matchPaths(ime, graph);
+        for (size_t limit : {1, 3, 20}) {
+            ime.setWordLimit(limit);
+            const auto best = matchPaths(ime, graph);
+            FCITX_ASSERT(best.size() == all.size()) << input << " " << limit;
+            for (const auto &[path, words] : best) {
+                const auto &expect = all.at(path);
+                FCITX_ASSERT(words.size() == std::min(limit, expect.size()))
+                    << input << " " << limit;
+                for (size_t i = 0; i < words.size(); i++) {
+                    // Words of the same cost may be chosen differently.
+                    FCITX_ASSERT(words[i].first == expect[i].first)
+                        << input << " " << limit << " " << i;
+                    FCITX_ASSERT(std::find(expect.begin(), expect.end(),
+                                           words[i]) != expect.end())
+                        << input << " " << words[i].second;
+                }
+            }
+        }
+    }
+    ime.setWordLimit(0);
+}
+
+void testWordLimit(JyutpingIME &ime) {
+    const char *dictFile = LIBIME_BINARY_DIR "/data/jyutping.dict";
+    // DATrie.
+    checkWordLimit(ime);
+    // Packed trie, both flat and block compressed.
+    for (auto [file, format] :
+         {std::make_pair(LIBIME_BINARY_DIR "/test/testcontext.mapped",
+                         JyutpingDictFormat::MappedBinary),
+          std::make_pair(LIBIME_BINARY_DIR "/test/testcontext.block",
+                         JyutpingDictFormat::BlockCompressedBinary)}) {
+        ime.dict()->save(JyutpingDictionary::SystemDict, file, format);
+        ime.dict()->load(JyutpingDictionary::SystemDict, file,
+                         JyutpingDictFormat::Binary);
+        checkWordLimit(ime);
+        ime.dict()->load(JyutpingDictionary::SystemDict, dictFile,
+                         JyutpingDictFormat::Binary);
+    }
+}
+
+// Counters of the context caches move with typing, and smaller cache sizes
+// evict more.
+void testCacheStats(JyutpingIME &ime) {
+    JyutpingContext context(&ime);
+    const auto &nodeStats = context.matchState().nodeCacheStats();
+    const auto &matchStats = context.matchState().matchCacheStats();
+    context.type(longInput);
+    FCITX_ASSERT(nodeStats.misses > 0 && matchStats.misses > 0);
+    FCITX_ASSERT(nodeStats.bytes > 0 && matchStats.bytes > 0);
+    const auto nodeBytes = nodeStats.bytes;
+    const auto matchBytes = matchStats.bytes;
+
+    // Typing the last character again reuses the cached paths.
+    const auto hits = nodeStats.hits + matchStats.hits;
+    context.backspace();
+    context.type(longInput + sizeof(longInput) - 2);
+    FCITX_ASSERT(nodeStats.hits + matchStats.hits > hits);
+
+    // Changing a size clears the contexts, and the caches with them.
+    ime.setNodeCacheSize(1);
+    ime.setMatchCacheSize(1);
+    FCITX_ASSERT(context.userInput().empty());
+    FCITX_ASSERT(nodeStats.bytes == 0 && matchStats.bytes == 0);
+
+    const auto nodeEvictions = nodeStats.evictions;
+    const auto matchEvictions = matchStats.evictions;
+    context.type(longInput);
+    FCITX_ASSERT(nodeStats.evictions > nodeEvictions);
+    FCITX_ASSERT(matchStats.evictions > matchEvictions);
+    FCITX_ASSERT(nodeStats.bytes < nodeBytes && matchStats.bytes < matchBytes);
+
+    ime.setNodeCacheSize(JyutpingMatchState::cacheSizeDefault);
+    ime.setMatchCacheSize(JyutpingMatchState::cacheSizeDefault);
+}
+
+// Edits only mark a deferred update as pending, and all of them share one
+// update.
+void testDeferUpdate(JyutpingIME &ime) {
+    constexpr char input[] = "ngodeiheoisik";
+    JyutpingContext expect(&ime);
+    expect.type(input);
+
+    size_t updates = 0;
+    ime.setUpdateStatsCallback(
+        [&updates](const JyutpingUpdateStats &) { updates++; });
+    JyutpingContext context(&ime);
+    context.setDeferUpdate(true);
+    for (const char *c = input; *c; c++) {
+        context.type(std::string(1, *c));
+        FCITX_ASSERT(context.hasPendingUpdate());
+        FCITX_ASSERT(context.candidates().empty());
+    }
+    FCITX_ASSERT(updates == 0);
+
+    context.updatePending();
+    FCITX_ASSERT(updates == 1);
+    FCITX_ASSERT(!context.hasPendingUpdate());
+    FCITX_ASSERT(candidateStrings(context, 20) == candidateStrings(expect, 20));
+    context.updatePending();
+    FCITX_ASSERT(updates == 1);
+    ime.setUpdateStatsCallback(nullptr);
+}
+
+} // namespace
+
+int main() {
+    JyutpingIME ime(std::make_unique<JyutpingDictionary>(),
+                    std::make_unique<UserLanguageModel>(LIBIME_BINARY_DIR
+                                                        "/data/zh_HK.lm"));
+    ime.dict()->load(JyutpingDictionary::SystemDict,
+                     LIBIME_BINARY_DIR "/data/jyutping.dict",
+                     JyutpingDictFormat::Binary);
+    ime.setScoreFilter(1.0f);
+
+    testUpdateTimeLimit(ime);
+    testSharedMatchCache(ime);
+    testCandidateOrder(ime);
+    testWordLimit(ime);
+    testCacheStats(ime);
+    testDeferUpdate(ime);
+    return 0;
+}
@@ -14,11 +14,306 @@
 #include "libime/jyutping/jyutpingdictionary.h"
 #include "libime/jyutping/jyutpingencoder.h"
 #include "testdir.h"
+#include <algorithm>
 #include <fcitx-utils/log.h>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace libime;
+using namespace libime::jyutping;
+
+std::vector<std::tuple<std::string, std::string, float>>
+allMatches(const JyutpingDictionary &dict, const char *data, size_t size) {
+    std::vector<std::tuple<std::string, std::string, float>> result;
+    dict.matchWords(data, size,
+                    [&result](std::string_view encodedJyutping,
+                              std::string_view hanzi, float cost) {
+                        result.emplace_back(encodedJyutping, hanzi, cost);
+                        return true;
+                    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::string dumpText(JyutpingDictionary &dict,
+                     size_t idx = JyutpingDictionary::SystemDict) {
+    std::stringstream ss;
+    dict.save(idx, ss, JyutpingDictFormat::Text);
+    return ss.str();
+}
+
+// Loading a truncated or corrupted packed file should fail, instead of
+// reading out of bounds.
+void testCorruptedPackedBinary(const char *file, JyutpingDictFormat format) {
+    std::stringstream buffer;
+    buffer << std::ifstream(file, std::ios::in | std::ios::binary).rdbuf();
+    const auto data = buffer.str();
+    const auto corruptedFile = std::string(file) + ".corrupted";
+    auto expectFail = [&corruptedFile](const std::string &content) {
+        {
+            std::ofstream out(corruptedFile, std::ios::out | std::ios::binary);
+            out << content;
+        }
+        JyutpingDictionary corrupted;
+        try {
+            corrupted.load(JyutpingDictionary::SystemDict,
+                           corruptedFile.c_str(), JyutpingDictFormat::Binary);
+            FCITX_ASSERT(false) << "Loading " << content.size() << " bytes";
+        } catch (const std::exception &) {
+        }
+    };
+    for (size_t size : {size_t(12), size_t(20), data.size() / 2,
+                        data.size() - 1}) {
+        expectFail(data.substr(0, size));
+    }
+    if (format == JyutpingDictFormat::MappedBinary) {
+        // Node offset after the end of file.
+        auto content = data;
+        content.replace(16, 4, "\xff\xff\xff\xf0");
+        expectFail(content);
+
+        // Mapped nodes are only checked when they are read, so broken links
+        // in the middle of the file are not noticed by load, but lookups
+        // must still stay in bounds.
+        content = data;
+        const auto nodeOffset =
+            (static_cast<uint32_t>(static_cast<uint8_t>(content[16])) << 24) |
+            (static_cast<uint32_t>(static_cast<uint8_t>(content[17])) << 16) |
+            (static_cast<uint32_t>(static_cast<uint8_t>(content[18])) << 8) |
+            static_cast<uint32_t>(static_cast<uint8_t>(content[19]));
+        const size_t middle =
+            nodeOffset + (content.size() - nodeOffset) / 2 / 16 * 16;
+        for (size_t i = 0; i < 64 && middle + i * 16 + 8 <= content.size();
+             i++) {
+            // Parent and end of a node.
+            content.replace(middle + i * 16, 8, 8, '\xff');
+        }
+        {
+            std::ofstream out(corruptedFile, std::ios::out | std::ios::binary);
+            out << content;
+        }
+        JyutpingDictionary corrupted;
+        corrupted.load(JyutpingDictionary::SystemDict, corruptedFile.c_str(),
+                       JyutpingDictFormat::Binary);
+        dumpText(corrupted);
+        const char c[] = {static_cast<char>(JyutpingInitial::J),
+                          static_cast<char>(JyutpingFinal::IN)};
+        allMatches(corrupted, c, 2);
+    }
+    if (format == JyutpingDictFormat::BlockCompressedBinary) {
+        // Checksum of the last block, it is only noticed when the block is
+        // decompressed during a lookup, which must not throw.
+        auto content = data;
+        content.back() = static_cast<char>(~content.back());
+        {
+            std::ofstream out(corruptedFile, std::ios::out | std::ios::binary);
+            out << content;
+        }
+        JyutpingDictionary corrupted;
+        corrupted.load(JyutpingDictionary::SystemDict, corruptedFile.c_str(),
+                       JyutpingDictFormat::Binary);
+        JyutpingDictionary intact;
+        intact.load(JyutpingDictionary::SystemDict, file,
+                    JyutpingDictFormat::Binary);
+        // Words in the damaged block are lost.
+        FCITX_ASSERT(dumpText(corrupted).size() < dumpText(intact).size());
+    }
+}
+
+void testPackedBinary(JyutpingDictionary &dict, const char *file,
+                      JyutpingDictFormat format) {
+    dict.save(JyutpingDictionary::SystemDict, file, format);
+
+    JyutpingDictionary mapped;
+    mapped.load(JyutpingDictionary::SystemDict, file,
+                JyutpingDictFormat::Binary);
+    JyutpingDictionary loaded;
+    std::ifstream in(file, std::ios::in | std::ios::binary);
+    loaded.load(JyutpingDictionary::SystemDict, in,
+                JyutpingDictFormat::Binary);
+
+    char c[] = {static_cast<char>(JyutpingInitial::J),
+                static_cast<char>(JyutpingFinal::IN),
+                static_cast<char>(JyutpingInitial::H),
+                static_cast<char>(JyutpingFinal::Invalid)};
+    for (size_t size : {2, 4}) {
+        auto expect = allMatches(dict, c, size);
+        FCITX_ASSERT(expect == allMatches(mapped, c, size));
+        FCITX_ASSERT(expect == allMatches(loaded, c, size));
+    }
+    auto text = dumpText(dict);
+    FCITX_ASSERT(text == dumpText(mapped));
+    FCITX_ASSERT(text == dumpText(loaded));
+
+    // Mapped dictionary is only in DATrie once unpacked.
+    const auto entries = dict.trie(JyutpingDictionary::SystemDict)->size();
+    FCITX_ASSERT(mapped.trie(JyutpingDictionary::SystemDict)->size() == 0);
+    FCITX_ASSERT(mapped.snapshot(JyutpingDictionary::SystemDict).size() ==
+                 entries);
+    JyutpingDictionary unpacked;
+    unpacked.load(JyutpingDictionary::SystemDict, file,
+                  JyutpingDictFormat::Binary);
+    FCITX_ASSERT(unpacked.unpack(JyutpingDictionary::SystemDict)->size() ==
+                 entries);
+    FCITX_ASSERT(text == dumpText(unpacked));
+
+    // Adding word to a mapped dictionary should still work.
+    mapped.addWord(JyutpingDictionary::SystemDict, "jin'hau", "現後");
+    FCITX_ASSERT(allMatches(mapped, c, 4).size() ==
+                 allMatches(dict, c, 4).size() + 1);
+
+    testCorruptedPackedBinary(file, format);
+}
+
+void testLoadTextParallel(JyutpingDictionary &dict) {
+    const char *file = LIBIME_BINARY_DIR "/test/testjyutpingdictionary.txt";
+    dict.save(JyutpingDictionary::SystemDict, file, JyutpingDictFormat::Text);
+    auto text = dumpText(dict);
+    for (size_t threads : {1, 3}) {
+        JyutpingDictionary loaded;
+        loaded.loadTextParallel(JyutpingDictionary::SystemDict, file, threads);
+        FCITX_ASSERT(text == dumpText(loaded));
+    }
+
+    // Costs are parsed the same way as loadText does.
+    {
+        std::ofstream out(file, std::ios::out | std::ios::binary);
+        out << "現後 jin'hau +1.5\n"
+            << " \t你好\tnei'hou\t-2 \r\n"
+            << "現後 jin'hau 0x1p-2\n"
+            << "你 nei -3.25abc\n";
+    }
+    JyutpingDictionary expect;
+    expect.load(JyutpingDictionary::SystemDict, file,
+                JyutpingDictFormat::Text);
+    for (size_t threads : {1, 3}) {
+        JyutpingDictionary loaded;
+        loaded.loadTextParallel(JyutpingDictionary::SystemDict, file, threads);
+        FCITX_ASSERT(dumpText(expect) == dumpText(loaded));
+    }
+}
+
+void testMatchWordsBatch(const JyutpingDictionary &dict) {
+    const char j = static_cast<char>(JyutpingInitial::J);
+    const char in = static_cast<char>(JyutpingFinal::IN);
+    const char h = static_cast<char>(JyutpingInitial::H);
+    const char au = static_cast<char>(JyutpingFinal::AU);
+    const char invalid = static_cast<char>(JyutpingFinal::Invalid);
+    std::vector<std::string> data = {
+        {j, in, h, au}, {j, in}, {h, au}, {j, in, h, invalid},
+        {j, in},        {j},     {j, in, h, au}};
+    // Enough keys to be split between threads.
+    std::vector<std::string_view> keys;
+    for (int i = 0; i < 100; i++) {
+        keys.insert(keys.end(), data.begin(), data.end());
+    }
+    for (size_t threads : {1, 3}) {
+        std::vector<std::vector<std::tuple<std::string, std::string, float>>>
+            result(keys.size());
+        std::mutex mutex;
+        dict.matchWordsBatch(
+            keys,
+            [&result, &mutex](size_t index, std::string_view encodedJyutping,
+                              std::string_view hanzi, float cost) {
+                std::lock_guard<std::mutex> lock(mutex);
+                result[index].emplace_back(encodedJyutping, hanzi, cost);
+                return true;
+            },
+            threads);
+        for (size_t i = 0; i < keys.size(); i++) {
+            std::sort(result[i].begin(), result[i].end());
+            FCITX_ASSERT(result[i] ==
+                         allMatches(dict, keys[i].data(), keys[i].size()));
+        }
+        FCITX_ASSERT(!result[0].empty());
+    }
+}
+
+void testMatchWordsStop(const JyutpingDictionary &dict) {
+    // Final wildcard.
+    char c[] = {static_cast<char>(JyutpingInitial::J),
+                static_cast<char>(JyutpingFinal::Invalid)};
+    FCITX_ASSERT(allMatches(dict, c, 2).size() > 1);
+    size_t count = 0;
+    dict.matchWords(c, 2,
+                    [&count](std::string_view, std::string_view, float) {
+                        count++;
+                        return false;
+                    });
+    FCITX_ASSERT(count == 1);
+}
+
+void testJournal() {
+    JyutpingDictionary dict;
+    std::stringstream journal;
+    dict.addWord(JyutpingDictionary::UserDict, "jin'hau", "現後");
+    FCITX_ASSERT(dict.journalSize(JyutpingDictionary::UserDict) == 1);
+    dict.saveJournal(JyutpingDictionary::UserDict, journal);
+    FCITX_ASSERT(dict.journalSize(JyutpingDictionary::UserDict) == 0);
+    dict.addWord(JyutpingDictionary::UserDict, "jin", "現", -1.0f);
+    dict.addWord(JyutpingDictionary::UserDict, "jin'hau", "現後", -2.0f);
+    dict.saveJournal(JyutpingDictionary::UserDict, journal);
+    // An incomplete write at the end.
+    std::stringstream truncated;
+    dict.addWord(JyutpingDictionary::UserDict, "hau", "後");
+    dict.saveJournal(JyutpingDictionary::UserDict, truncated);
+    journal << truncated.str().substr(0, truncated.str().size() - 1);
+    // A chunk appended after the incomplete one is still replayed, and the
+    // incomplete one is not mistaken for words.
+    dict.addWord(JyutpingDictionary::UserDict, "jin'hau", "現後", -3.0f);
+    dict.saveJournal(JyutpingDictionary::UserDict, journal);
+
+    std::stringstream expect;
+    dict.save(JyutpingDictionary::UserDict, expect, JyutpingDictFormat::Text);
+
+    JyutpingDictionary replayed;
+    FCITX_ASSERT(replayed.loadJournal(JyutpingDictionary::UserDict,
+                                      journal) == 4);
+    FCITX_ASSERT(replayed.journalSize(JyutpingDictionary::UserDict) == 0);
+    replayed.addWord(JyutpingDictionary::UserDict, "hau", "後");
+    std::stringstream text;
+    replayed.save(JyutpingDictionary::UserDict, text,
+                  JyutpingDictFormat::Text);
+    FCITX_ASSERT(expect.str() == text.str());
+}
+
+// Removed words and cleared dictionaries stay so after replay.
+void testJournalRemove() {
+    JyutpingDictionary dict;
+    std::stringstream journal;
+    dict.addWord(JyutpingDictionary::UserDict, "jin'hau", "現後");
+    dict.addWord(JyutpingDictionary::UserDict, "jin", "現");
+    dict.saveJournal(JyutpingDictionary::UserDict, journal);
+    FCITX_ASSERT(dict.removeWord(JyutpingDictionary::UserDict, "jin", "現"));
+    FCITX_ASSERT(!dict.removeWord(JyutpingDictionary::UserDict, "hau", "後"));
+    FCITX_ASSERT(dict.journalSize(JyutpingDictionary::UserDict) == 1);
+    dict.saveJournal(JyutpingDictionary::UserDict, journal);
+
+    JyutpingDictionary replayed;
+    FCITX_ASSERT(replayed.loadJournal(JyutpingDictionary::UserDict,
+                                      journal) == 3);
+    FCITX_ASSERT(dumpText(dict, JyutpingDictionary::UserDict) ==
+                 dumpText(replayed, JyutpingDictionary::UserDict));
+    FCITX_ASSERT(replayed.trie(JyutpingDictionary::UserDict)->size() == 1);
+
+    dict.clear(JyutpingDictionary::UserDict);
+    dict.addWord(JyutpingDictionary::UserDict, "hau", "後");
+    journal.clear();
+    dict.saveJournal(JyutpingDictionary::UserDict, journal);
+    journal.seekg(0);
+    JyutpingDictionary cleared;
+    FCITX_ASSERT(cleared.loadJournal(JyutpingDictionary::UserDict,
+                                     journal) == 5);
+    FCITX_ASSERT(dumpText(dict, JyutpingDictionary::UserDict) ==
+                 dumpText(cleared, JyutpingDictionary::UserDict));
+    FCITX_ASSERT(cleared.trie(JyutpingDictionary::UserDict)->size() == 1);
+}
 
 int main() {
-    using namespace libime;
-    using namespace libime::jyutping;
     JyutpingDictionary dict;
     dict.load(JyutpingDictionary::SystemDict,
               LIBIME_BINARY_DIR "/data/jyutping.dict",
@@ -58,6 +353,17 @@ int main() {
 
     dict.save(0, LIBIME_BINARY_DIR "/test/testjyutpingdictionary.dict",
               JyutpingDictFormat::Binary);
+    testPackedBinary(dict,
+                     LIBIME_BINARY_DIR "/test/testjyutpingdictionary.mapped",
+                     JyutpingDictFormat::MappedBinary);
+    testPackedBinary(dict,
+                     LIBIME_BINARY_DIR "/test/testjyutpingdictionary.block",
+                     JyutpingDictFormat::BlockCompressedBinary);
+    testLoadTextParallel(dict);
+    testMatchWordsBatch(dict);
+    testMatchWordsStop(dict);
+    testJournal();
+    testJournalRemove();
     // dict.save(0, std::cout, JyutpingDictFormat::Text);
     return 0;
 }
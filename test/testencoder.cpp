@@ -6,7 +6,10 @@
 
 #include "libime/jyutping/jyutpingdata.h"
 #include "libime/jyutping/jyutpingencoder.h"
+#include <algorithm>
 #include <fcitx-utils/log.h>
+#include <string>
+#include <vector>
 
 using namespace libime;
 using namespace libime::jyutping;
@@ -28,6 +31,55 @@ void dfs(const SegmentGraph &segs) {
     segs.dfs(callback);
 }
 
+bool sameGraph(const SegmentGraph &lhs, const SegmentGraph &rhs) {
+    if (lhs.data() != rhs.data()) {
+        return false;
+    }
+    for (size_t i = 0; i <= lhs.size(); i++) {
+        std::vector<size_t> lhsNexts, rhsNexts;
+        for (const auto &node : lhs.nodes(i)) {
+            for (const auto &next : node.nexts()) {
+                lhsNexts.push_back(next.index());
+            }
+        }
+        for (const auto &node : rhs.nodes(i)) {
+            for (const auto &next : node.nexts()) {
+                rhsNexts.push_back(next.index());
+            }
+        }
+        if (lhsNexts != rhsNexts) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testIncrementalParse() {
+    JyutpingIncrementalParser parser;
+    std::string input = "neizaudaajatgeoi'ngngaatjinhauonjathaaceoi";
+    // Type one character at a time, then remove them.
+    for (size_t i = 1; i <= input.size(); i++) {
+        auto text = input.substr(0, i);
+        FCITX_ASSERT(sameGraph(parser.parse(text),
+                               JyutpingEncoder::parseUserJyutping(text)))
+            << text;
+    }
+    for (size_t i = input.size(); i > 0; i--) {
+        auto text = input.substr(0, i);
+        FCITX_ASSERT(sameGraph(parser.parse(text, false),
+                               JyutpingEncoder::parseUserJyutping(text, false)))
+            << text;
+    }
+    // Edit in the middle.
+    for (size_t i = 0; i < input.size(); i++) {
+        auto text = input;
+        text.insert(i, "'");
+        FCITX_ASSERT(sameGraph(parser.parse(text),
+                               JyutpingEncoder::parseUserJyutping(text)))
+            << text;
+    }
+}
+
 int main() {
     std::unordered_set<std::string> seen;
     for (auto &p : getJyutpingMap()) {
@@ -54,7 +106,33 @@ int main() {
         FCITX_ASSERT(fullJyutping == jyutping)
             << " " << fullJyutping << " " << jyutping;
         std::cout << encode << "," << std::endl;
+
+        const auto *entry = findJyutpingSyllable(jyutping);
+        FCITX_ASSERT(entry && entry->initial == initial &&
+                     entry->final == final);
+    }
+
+    char buffer[4];
+    FCITX_ASSERT(JyutpingEncoder::encodedFullJyutpingSize("jin'hau") == 4);
+    FCITX_ASSERT(JyutpingEncoder::encodeFullJyutping("jin'hau", buffer,
+                                                     sizeof(buffer)) == 4);
+    auto expected = JyutpingEncoder::encodeFullJyutping("jin'hau");
+    FCITX_ASSERT(std::equal(expected.begin(), expected.end(), buffer));
+    FCITX_ASSERT(!findJyutpingSyllable("jinx"));
+
+    auto expansion = getSyllableExpansion("jin");
+    FCITX_ASSERT(expansion.size() == 1 &&
+                 expansion[0].initial == JyutpingInitial::J &&
+                 expansion[0].finals.size() == 1 &&
+                 expansion[0].finals[0].final == JyutpingFinal::IN);
+    expansion = getSyllableExpansion("m");
+    FCITX_ASSERT(expansion.size() == 1 &&
+                 expansion[0].initial == JyutpingInitial::M);
+    for (const auto &final : expansion[0].finals) {
+        FCITX_ASSERT(JyutpingEncoder::isValidInitialFinal(JyutpingInitial::M,
+                                                          final.final));
     }
+    FCITX_ASSERT(getSyllableExpansion("x").empty());
 
     dfs(JyutpingEncoder::parseUserJyutping("sangwut"));
     dfs(JyutpingEncoder::parseUserJyutping("ngng"));
@@ -64,6 +142,7 @@ int main() {
     dfs(JyutpingEncoder::parseUserJyutping("jinhauonjathaa"));
     dfs(JyutpingEncoder::parseUserJyutping("jinha"));
     dfs(JyutpingEncoder::parseUserJyutping("jinhau"));
+    testIncrementalParse();
 
     return 0;
 }
@@ -63,7 +63,7 @@ int main(int argc, char *argv[]) {
             } else {
                 idx = word[0] - '1';
             }
-            if (c.candidates().size() >= idx) {
+            if (c.candidatesTo(idx + 1).size() > idx) {
                 c.select(idx);
             }
         } else if (word == "all") {
@@ -78,7 +78,9 @@ int main(int argc, char *argv[]) {
         std::cout << "PREEDIT:  " << c.preedit() << std::endl;
         std::cout << "SENTENCE: " << c.sentence() << std::endl;
         size_t count = 1;
-        for (auto &candidate : c.candidates()) {
+        const auto &candidates =
+            printAll ? c.candidates() : c.candidatesTo(10);
+        for (auto &candidate : candidates) {
             std::cout << (count % 10) << ": ";
             for (auto node : candidate.sentence()) {
                 auto &jyutping = static_cast<const JyutpingLatticeNode *>(node)
@@ -6,25 +6,51 @@
 
 #include "libime/jyutping/jyutpingdictionary.h"
 #include "libime/jyutping/jyutpingencoder.h"
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <getopt.h>
 #include <iostream>
 
 void usage(const char *argv0) {
-    std::cout << "Usage: " << argv0 << " [-d] <source> <dest>" << std::endl
+    std::cout << "Usage: " << argv0
+              << " [-d] [-m] [-b] [-j <threads>] <source> <dest>" << std::endl
               << "-d: Dump binary to text" << std::endl
+              << "-m: Save binary in the uncompressed format that can be "
+                 "memory mapped"
+              << std::endl
+              << "-b: Save binary in the block compressed format that is "
+                 "decompressed on demand"
+              << std::endl
+              << "-j: Compile text with the given number of threads, 0 means "
+                 "all cores"
+              << std::endl
               << "-h: Show this help" << std::endl;
 }
 
 int main(int argc, char *argv[]) {
 
     bool dump = false;
+    bool mapped = false;
+    bool block = false;
+    bool parallel = false;
+    size_t threads = 0;
     int c;
-    while ((c = getopt(argc, argv, "dh")) != -1) {
+    while ((c = getopt(argc, argv, "dmbj:h")) != -1) {
         switch (c) {
         case 'd':
             dump = true;
             break;
+        case 'm':
+            mapped = true;
+            break;
+        case 'b':
+            block = true;
+            break;
+        case 'j':
+            parallel = true;
+            threads = std::strtoul(optarg, nullptr, 10);
+            break;
         case 'h':
             usage(argv[0]);
             return 0;
@@ -42,8 +68,19 @@ int main(int argc, char *argv[]) {
     using namespace libime::jyutping;
     JyutpingDictionary dict;
 
-    dict.load(JyutpingDictionary::SystemDict, argv[optind],
-              dump ? JyutpingDictFormat::Binary : JyutpingDictFormat::Text);
+    if (parallel && !dump) {
+        auto start = std::chrono::steady_clock::now();
+        auto lines = dict.loadTextParallel(JyutpingDictionary::SystemDict,
+                                           argv[optind], threads);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::cerr << "Compiled " << lines << " lines in " << elapsed.count()
+                  << "s, " << static_cast<size_t>(lines / elapsed.count())
+                  << " lines/s" << std::endl;
+    } else {
+        dict.load(JyutpingDictionary::SystemDict, argv[optind],
+                  dump ? JyutpingDictFormat::Binary : JyutpingDictFormat::Text);
+    }
 
     std::ofstream fout;
     std::ostream *out;
@@ -53,7 +90,14 @@ int main(int argc, char *argv[]) {
         fout.open(argv[optind + 1], std::ios::out | std::ios::binary);
         out = &fout;
     }
-    dict.save(JyutpingDictionary::SystemDict, *out,
-              dump ? JyutpingDictFormat::Text : JyutpingDictFormat::Binary);
+    JyutpingDictFormat format = JyutpingDictFormat::Binary;
+    if (dump) {
+        format = JyutpingDictFormat::Text;
+    } else if (mapped) {
+        format = JyutpingDictFormat::MappedBinary;
+    } else if (block) {
+        format = JyutpingDictFormat::BlockCompressedBinary;
+    }
+    dict.save(JyutpingDictionary::SystemDict, *out, format);
     return 0;
 }